@@ -490,6 +490,8 @@ int _show_death(Object* obj, int anim)
 
     if (!_critter_flag_check(obj->pid, CRITTER_FLAT)) {
         obj->flags |= OBJECT_NO_BLOCK;
+        combatInvalidateLineOfFireCache();
+        pathfinderInvalidateReachability();
         if (_obj_toggle_flat(obj, &tempRect) == 0) {
             rectUnion(&dirtyRect, &tempRect, &dirtyRect);
         }
@@ -1,5 +1,6 @@
 #include "animation.h"
 
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@
 #include "item.h"
 #include "kb.h"
 #include "map.h"
+#include "memory.h"
 #include "mouse.h"
 #include "object.h"
 #include "party_member.h"
@@ -37,9 +39,20 @@
 
 namespace fallout {
 
-#define ANIMATION_SEQUENCE_LIST_CAPACITY 32
+// CE: Sequences and sads are stored in chunks which are allocated on demand,
+// so that addresses of existing entries never change. Originally there was
+// one chunk of each.
+#define ANIMATION_SEQUENCE_CHUNK_LENGTH 32
+#define ANIMATION_SEQUENCE_CHUNK_COUNT 16
+#define ANIMATION_SEQUENCE_MAX_CAPACITY (ANIMATION_SEQUENCE_CHUNK_LENGTH * ANIMATION_SEQUENCE_CHUNK_COUNT)
+
+// Number of sequences which can only be taken by reserved animations.
+#define ANIMATION_SEQUENCE_RESERVED_HEADROOM 12
+
 #define ANIMATION_DESCRIPTION_LIST_CAPACITY 55
-#define ANIMATION_SAD_LIST_CAPACITY 24
+
+#define ANIMATION_SAD_CHUNK_LENGTH 24
+#define ANIMATION_SAD_CHUNK_COUNT 16
 
 #define ANIMATION_SEQUENCE_FORCED 0x01
 
@@ -291,6 +304,14 @@ static unsigned int animationComputeTicksPerFrame(Object* object, int fid);
 
 static void reportOverloaded(Object* critter);
 
+static AnimationSequence* animationSequenceAt(int index);
+static bool animationSequencesGrow();
+static AnimationSad* animationSadAt(int index);
+static bool animationSadsReserve();
+static void animationFreeChunks();
+
+static void reachabilityFieldBuild(Object* object, int maxDistance);
+
 // 0x510718
 static int gAnimationCurrentSad = 0;
 
@@ -307,7 +328,8 @@ static bool gAnimationInStop = false;
 static bool _anim_in_bk = false;
 
 // 0x530014
-static AnimationSad gAnimationSads[ANIMATION_SAD_LIST_CAPACITY];
+static AnimationSad* gAnimationSadChunks[ANIMATION_SAD_CHUNK_COUNT];
+static int gAnimationSadCapacity = 0;
 
 #define PATH_NODE_CAPACITY 10000
 
@@ -315,7 +337,23 @@ static AnimationSad gAnimationSads[ANIMATION_SAD_LIST_CAPACITY];
 static PathNode gClosedPathNodeList[PATH_NODE_CAPACITY];
 
 // 0x54CC14
-static AnimationSequence gAnimationSequences[32];
+static AnimationSequence* gAnimationSequenceChunks[ANIMATION_SEQUENCE_CHUNK_COUNT];
+static int gAnimationSequenceCapacity = 0;
+
+// CE: Earliest time any of the sads is due to advance, as a delay since the
+// last pass in `_object_animate`. The pass is forced when sads are added.
+static unsigned int gAnimationLastPassTime = 0;
+static unsigned int gAnimationNextPassDelay = 0;
+static bool gAnimationPassPending = false;
+
+// CE: Instrumentation, reported on exit.
+static int gAnimationSequencesPeak = 0;
+static int gAnimationSadsPeak = 0;
+static unsigned int gAnimationPasses = 0;
+static unsigned int gAnimationPassesSkipped = 0;
+static unsigned int gAnimationSadsAdvanced = 0;
+static unsigned int gAnimationPassTicksTotal = 0;
+static unsigned int gAnimationPassTicksMax = 0;
 
 // 0x561814
 static unsigned char gPathfinderProcessedTiles[5000];
@@ -326,10 +364,40 @@ static PathNode gOpenPathNodeList[PATH_NODE_CAPACITY];
 // 0x56C7DC
 static int gAnimationDescriptionCurrentIndex;
 
+// CE: Shortest path lengths (in steps) from critter's tile to every tile it
+// can reach within a given number of steps. See
+// `pathfinderGetReachableDistance`.
+typedef struct ReachabilityField {
+    Object* object;
+    int tile;
+    int elevation;
+    int maxDistance;
+    bool inCombat;
+    unsigned int generation;
+    unsigned int stamp;
+} ReachabilityField;
+
+static ReachabilityField gReachabilityField;
+static unsigned int gReachabilityGeneration = 1;
+
+// Tile belongs to current field when its stamp matches field stamp.
+static unsigned int gReachabilityStamps[HEX_GRID_SIZE];
+static unsigned short gReachabilityDistances[HEX_GRID_SIZE];
+
+// Memoized results of `_make_path` to reachable tiles, -1 if not yet known.
+static short gReachabilityPathLengths[HEX_GRID_SIZE];
+
+static int gReachabilityQueue[HEX_GRID_SIZE];
+
 // anim_init
 // 0x413A20
 void animationInit()
 {
+    // CE: Start with original number of sequences.
+    if (gAnimationSequenceCapacity == 0) {
+        animationSequencesGrow();
+    }
+
     gAnimationInInit = true;
     animationReset();
     gAnimationInInit = false;
@@ -346,9 +414,9 @@ void animationReset()
     gAnimationCurrentSad = 0;
     gAnimationSequenceCurrentIndex = -1;
 
-    for (int index = 0; index < ANIMATION_SEQUENCE_LIST_CAPACITY; index++) {
-        gAnimationSequences[index].step = ANIM_COMPLETE;
-        gAnimationSequences[index].flags = 0;
+    for (int index = 0; index < gAnimationSequenceCapacity; index++) {
+        animationSequenceAt(index)->step = ANIM_COMPLETE;
+        animationSequenceAt(index)->flags = 0;
     }
 }
 
@@ -357,6 +425,20 @@ void animationExit()
 {
     // NOTE: Uninline.
     animationStop();
+
+    debugPrint("Animations: peak %d sequences (%d allocated), peak %d sads (%d allocated)\n",
+        gAnimationSequencesPeak,
+        gAnimationSequenceCapacity,
+        gAnimationSadsPeak,
+        gAnimationSadCapacity);
+    debugPrint("Animations: %u passes (%u skipped), %u frames advanced, %u ms total, %u ms max per pass\n",
+        gAnimationPasses,
+        gAnimationPassesSkipped,
+        gAnimationSadsAdvanced,
+        gAnimationPassTicksTotal,
+        gAnimationPassTicksMax);
+
+    animationFreeChunks();
 }
 
 // 0x413AF4
@@ -375,7 +457,7 @@ int reg_anim_begin(int requestOptions)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[v1]);
+    AnimationSequence* animationSequence = animationSequenceAt(v1);
     animationSequence->flags |= ANIM_SEQ_ACCUMULATING;
 
     if ((requestOptions & ANIMATION_REQUEST_RESERVED) != 0) {
@@ -394,6 +476,10 @@ int reg_anim_begin(int requestOptions)
 
     gAnimationDescriptionCurrentIndex = 0;
 
+    if (v1 + 1 > gAnimationSequencesPeak) {
+        gAnimationSequencesPeak = v1 + 1;
+    }
+
     return 0;
 }
 
@@ -402,8 +488,8 @@ static int _anim_free_slot(int requestOptions)
 {
     int v1 = -1;
     int v2 = 0;
-    for (int index = 0; index < ANIMATION_SEQUENCE_LIST_CAPACITY; index++) {
-        AnimationSequence* animationSequence = &(gAnimationSequences[index]);
+    for (int index = 0; index < gAnimationSequenceCapacity; index++) {
+        AnimationSequence* animationSequence = animationSequenceAt(index);
         if (animationSequence->step != ANIM_COMPLETE || (animationSequence->flags & ANIM_SEQ_ACCUMULATING) != 0 || (animationSequence->flags & ANIM_SEQ_0x20) != 0) {
             if (!(animationSequence->flags & ANIM_SEQ_RESERVED)) {
                 v2++;
@@ -413,13 +499,21 @@ static int _anim_free_slot(int requestOptions)
         }
     }
 
+    // CE: Add more sequences instead of dropping animation.
+    if (v1 == -1) {
+        int index = gAnimationSequenceCapacity;
+        if (animationSequencesGrow()) {
+            v1 = index;
+        }
+    }
+
     if (v1 == -1) {
         if ((requestOptions & ANIMATION_REQUEST_RESERVED) != 0) {
             debugPrint("Unable to begin reserved animation!\n");
         }
 
         return -1;
-    } else if ((requestOptions & ANIMATION_REQUEST_RESERVED) != 0 || v2 < 20) {
+    } else if ((requestOptions & ANIMATION_REQUEST_RESERVED) != 0 || v2 < ANIMATION_SEQUENCE_MAX_CAPACITY - ANIMATION_SEQUENCE_RESERVED_HEADROOM) {
         return v1;
     }
 
@@ -437,7 +531,7 @@ int _register_priority(int a1)
         return -1;
     }
 
-    gAnimationSequences[gAnimationSequenceCurrentIndex].flags |= ANIM_SEQ_PRIORITIZED;
+    animationSequenceAt(gAnimationSequenceCurrentIndex)->flags |= ANIM_SEQ_PRIORITIZED;
 
     return 0;
 }
@@ -445,8 +539,8 @@ int _register_priority(int a1)
 // 0x413C4C
 int reg_anim_clear(Object* a1)
 {
-    for (int animationSequenceIndex = 0; animationSequenceIndex < ANIMATION_SEQUENCE_LIST_CAPACITY; animationSequenceIndex++) {
-        AnimationSequence* animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    for (int animationSequenceIndex = 0; animationSequenceIndex < gAnimationSequenceCapacity; animationSequenceIndex++) {
+        AnimationSequence* animationSequence = animationSequenceAt(animationSequenceIndex);
         if (animationSequence->step == ANIM_COMPLETE) {
             continue;
         }
@@ -484,7 +578,7 @@ int reg_anim_end()
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     animationSequence->step = 0;
     animationSequence->length = gAnimationDescriptionCurrentIndex;
     animationSequence->animationIndex = -1;
@@ -528,11 +622,11 @@ static void _anim_cleanup()
         return;
     }
 
-    for (int index = 0; index < ANIMATION_SEQUENCE_LIST_CAPACITY; index++) {
-        gAnimationSequences[index].flags &= ~(ANIM_SEQ_ACCUMULATING | ANIM_SEQ_0x10);
+    for (int index = 0; index < gAnimationSequenceCapacity; index++) {
+        animationSequenceAt(index)->flags &= ~(ANIM_SEQ_ACCUMULATING | ANIM_SEQ_0x10);
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     for (int index = 0; index < gAnimationDescriptionCurrentIndex; index++) {
         AnimationDescription* animationDescription = &(animationSequence->animations[index]);
         if (animationDescription->artCacheKey != nullptr) {
@@ -562,8 +656,8 @@ static int _check_registry(Object* obj)
         return 0;
     }
 
-    for (int animationSequenceIndex = 0; animationSequenceIndex < ANIMATION_SEQUENCE_LIST_CAPACITY; animationSequenceIndex++) {
-        AnimationSequence* animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    for (int animationSequenceIndex = 0; animationSequenceIndex < gAnimationSequenceCapacity; animationSequenceIndex++) {
+        AnimationSequence* animationSequence = animationSequenceAt(animationSequenceIndex);
 
         if (animationSequenceIndex != gAnimationSequenceCurrentIndex && animationSequence->step != ANIM_COMPLETE) {
             for (int animationDescriptionIndex = 0; animationDescriptionIndex < animationSequence->length; animationDescriptionIndex++) {
@@ -591,8 +685,8 @@ int animationIsBusy(Object* a1)
         return 0;
     }
 
-    for (int animationSequenceIndex = 0; animationSequenceIndex < ANIMATION_SEQUENCE_LIST_CAPACITY; animationSequenceIndex++) {
-        AnimationSequence* animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    for (int animationSequenceIndex = 0; animationSequenceIndex < gAnimationSequenceCapacity; animationSequenceIndex++) {
+        AnimationSequence* animationSequence = animationSequenceAt(animationSequenceIndex);
         if (animationSequenceIndex != gAnimationSequenceCurrentIndex && animationSequence->step != ANIM_COMPLETE) {
             for (int animationDescriptionIndex = 0; animationDescriptionIndex < animationSequence->length; animationDescriptionIndex++) {
                 AnimationDescription* animationDescription = &(animationSequence->animations[animationDescriptionIndex]);
@@ -628,7 +722,7 @@ int animationRegisterMoveToObject(Object* owner, Object* destination, int action
         return 0;
     }
 
-    AnimationDescription* animationDescription = &(gAnimationSequences[gAnimationSequenceCurrentIndex].animations[gAnimationDescriptionCurrentIndex]);
+    AnimationDescription* animationDescription = &(animationSequenceAt(gAnimationSequenceCurrentIndex)->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_OBJECT;
     animationDescription->anim = ANIM_WALK;
     animationDescription->owner = owner;
@@ -669,7 +763,7 @@ int animationRegisterRunToObject(Object* owner, Object* destination, int actionP
         return animationRegisterMoveToObject(owner, destination, actionPoints, delay);
     }
 
-    AnimationDescription* animationDescription = &(gAnimationSequences[gAnimationSequenceCurrentIndex].animations[gAnimationDescriptionCurrentIndex]);
+    AnimationDescription* animationDescription = &(animationSequenceAt(gAnimationSequenceCurrentIndex)->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_OBJECT;
     animationDescription->owner = owner;
     animationDescription->destination = destination;
@@ -709,7 +803,7 @@ int animationRegisterMoveToTile(Object* owner, int tile, int elevation, int acti
         return 0;
     }
 
-    AnimationDescription* animationDescription = &(gAnimationSequences[gAnimationSequenceCurrentIndex].animations[gAnimationDescriptionCurrentIndex]);
+    AnimationDescription* animationDescription = &(animationSequenceAt(gAnimationSequenceCurrentIndex)->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_TILE;
     animationDescription->anim = ANIM_WALK;
     animationDescription->owner = owner;
@@ -751,7 +845,7 @@ int animationRegisterRunToTile(Object* owner, int tile, int elevation, int actio
         return animationRegisterMoveToTile(owner, tile, elevation, actionPoints, delay);
     }
 
-    AnimationDescription* animationDescription = &(gAnimationSequences[gAnimationSequenceCurrentIndex].animations[gAnimationDescriptionCurrentIndex]);
+    AnimationDescription* animationDescription = &(animationSequenceAt(gAnimationSequenceCurrentIndex)->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_TILE;
     animationDescription->owner = owner;
     animationDescription->tile = tile;
@@ -793,7 +887,7 @@ int animationRegisterMoveToTileStraight(Object* object, int tile, int elevation,
         return 0;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
 
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_TILE_STRAIGHT;
@@ -828,7 +922,7 @@ int animationRegisterMoveToTileStraightAndWaitForComplete(Object* owner, int til
         return 0;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_MOVE_TO_TILE_STRAIGHT_AND_WAIT_FOR_COMPLETE;
     animationDescription->owner = owner;
@@ -858,7 +952,7 @@ int animationRegisterAnimate(Object* owner, int anim, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ANIMATE;
     animationDescription->owner = owner;
@@ -886,7 +980,7 @@ int animationRegisterAnimateReversed(Object* owner, int anim, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ANIMATE_REVERSED;
     animationDescription->owner = owner;
@@ -915,7 +1009,7 @@ int animationRegisterAnimateAndHide(Object* owner, int anim, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ANIMATE_AND_HIDE;
     animationDescription->owner = owner;
@@ -944,7 +1038,7 @@ int animationRegisterRotateToTile(Object* owner, int tile)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ROTATE_TO_TILE;
     animationDescription->delay = -1;
@@ -965,7 +1059,7 @@ int animationRegisterRotateClockwise(Object* owner)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ROTATE_CLOCKWISE;
     animationDescription->delay = -1;
@@ -985,7 +1079,7 @@ int animationRegisterRotateCounterClockwise(Object* owner)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ROTATE_COUNTER_CLOCKWISE;
     animationDescription->delay = -1;
@@ -1007,7 +1101,7 @@ int animationRegisterHideObject(Object* object)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_HIDE;
     animationDescription->delay = -1;
@@ -1027,7 +1121,7 @@ int animationRegisterHideObjectForced(Object* object)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_HIDE;
     animationDescription->delay = -1;
@@ -1047,7 +1141,7 @@ int animationRegisterCallback(void* param1, void* param2, AnimationCallback* pro
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_CALLBACK;
     animationDescription->extendedFlags = 0;
@@ -1072,7 +1166,7 @@ int animationRegisterCallback3(void* param1, void* param2, void* param3, Animati
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_CALLBACK3;
     animationDescription->extendedFlags = 0;
@@ -1096,7 +1190,7 @@ int animationRegisterCallbackForced(void* a1, void* a2, AnimationCallback* proc,
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_CALLBACK;
     animationDescription->extendedFlags = ANIMATION_SEQUENCE_FORCED;
@@ -1125,7 +1219,7 @@ int animationRegisterSetFlag(Object* object, int flag, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_SET_FLAG;
     animationDescription->artCacheKey = nullptr;
@@ -1150,7 +1244,7 @@ int animationRegisterUnsetFlag(Object* object, int flag, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_UNSET_FLAG;
     animationDescription->artCacheKey = nullptr;
@@ -1171,7 +1265,7 @@ int animationRegisterSetFid(Object* owner, int fid, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_SET_FID;
     animationDescription->owner = owner;
@@ -1202,7 +1296,7 @@ int animationRegisterTakeOutWeapon(Object* owner, int weaponAnimationCode, int d
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_TAKE_OUT_WEAPON;
     animationDescription->anim = ANIM_TAKE_OUT;
@@ -1231,7 +1325,7 @@ int animationRegisterSetLightDistance(Object* owner, int lightDistance, int dela
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_SET_LIGHT_DISTANCE;
     animationDescription->artCacheKey = nullptr;
@@ -1254,7 +1348,7 @@ int animationRegisterToggleOutline(Object* object, bool outline, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_TOGGLE_OUTLINE;
     animationDescription->artCacheKey = nullptr;
@@ -1275,7 +1369,7 @@ int animationRegisterPlaySoundEffect(Object* owner, const char* soundEffectName,
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_CALLBACK;
     animationDescription->owner = owner;
@@ -1307,7 +1401,7 @@ int animationRegisterAnimateForever(Object* owner, int anim, int delay)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_ANIMATE_FOREVER;
     animationDescription->owner = owner;
@@ -1340,9 +1434,9 @@ int animationRegisterPing(int flags, int delay)
         return -1;
     }
 
-    gAnimationSequences[animationSequenceIndex].flags = ANIM_SEQ_0x10;
+    animationSequenceAt(animationSequenceIndex)->flags = ANIM_SEQ_0x10;
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->owner = nullptr;
     animationDescription->kind = ANIM_KIND_PING;
@@ -1362,7 +1456,7 @@ static int animationRunSequence(int animationSequenceIndex)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(animationSequenceIndex);
     if (animationSequence->step == ANIM_COMPLETE) {
         return -1;
     }
@@ -1518,7 +1612,7 @@ static int animationRunSequence(int animationSequenceIndex)
             rc = _anim_set_continue(animationSequenceIndex, 0);
             break;
         case ANIM_KIND_PING:
-            gAnimationSequences[animationDescription->animationSequenceIndex].flags &= ~ANIM_SEQ_0x10;
+            animationSequenceAt(animationDescription->animationSequenceIndex)->flags &= ~ANIM_SEQ_0x10;
             rc = _anim_set_continue(animationDescription->animationSequenceIndex, 1);
             if (rc != -1) {
                 rc = _anim_set_continue(animationSequenceIndex, 0);
@@ -1549,7 +1643,7 @@ static int _anim_set_continue(int animationSequenceIndex, int a2)
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(animationSequenceIndex);
     if (animationSequence->step == ANIM_COMPLETE) {
         return -1;
     }
@@ -1577,13 +1671,13 @@ static int _anim_set_end(int animationSequenceIndex)
         return -1;
     }
 
-    animationSequence = &(gAnimationSequences[animationSequenceIndex]);
+    animationSequence = animationSequenceAt(animationSequenceIndex);
     if (animationSequence->step == ANIM_COMPLETE) {
         return -1;
     }
 
     for (i = 0; i < gAnimationCurrentSad; i++) {
-        AnimationSad* sad = &(gAnimationSads[i]);
+        AnimationSad* sad = animationSadAt(i);
         if (sad->animationSequenceIndex == animationSequenceIndex) {
             sad->step = ANIM_COMPLETE;
         }
@@ -1631,8 +1725,8 @@ static int _anim_set_end(int animationSequenceIndex)
 
                         if (k == animationSequence->animationIndex) {
                             for (int m = 0; m < gAnimationCurrentSad; m++) {
-                                if (gAnimationSads[m].obj == owner) {
-                                    gAnimationSads[m].step = ANIM_COMPLETE;
+                                if (animationSadAt(m)->obj == owner) {
+                                    animationSadAt(m)->step = ANIM_COMPLETE;
                                     break;
                                 }
                             }
@@ -1917,6 +2011,120 @@ int pathfinderFindPath(Object* object, int from, int to, unsigned char* rotation
     return 0;
 }
 
+// CE: Forgets reachability field. Must be called whenever blocking objects
+// are moved, added, removed, shown, hidden, opened, closed, or locked.
+void pathfinderInvalidateReachability()
+{
+    gReachabilityGeneration++;
+
+    // Zero generation denotes field that was never built.
+    if (gReachabilityGeneration == 0) {
+        gReachabilityGeneration = 1;
+    }
+}
+
+// CE: Returns length of the shortest path from object's tile to given tile,
+// or -1 if it cannot be reached within `maxDistance` steps. Passability
+// matches `_make_path`, so the result is never longer than the path it would
+// build.
+//
+// The field is built once per object position and reused until it's
+// invalidated, so lookups are O(1).
+int pathfinderGetReachableDistance(Object* object, int tile, int maxDistance)
+{
+    if (!hexGridTileIsValid(tile)) {
+        return -1;
+    }
+
+    ReachabilityField* field = &gReachabilityField;
+    if (field->generation != gReachabilityGeneration
+        || field->object != object
+        || field->tile != object->tile
+        || field->elevation != object->elevation
+        || field->maxDistance != maxDistance
+        || field->inCombat != isInCombat()) {
+        reachabilityFieldBuild(object, maxDistance);
+    }
+
+    if (gReachabilityStamps[tile] != field->stamp) {
+        return -1;
+    }
+
+    return gReachabilityDistances[tile];
+}
+
+// CE: Same as `_make_path(object, object->tile, tile, nullptr, 1)`, but
+// returns 0 without searching when the tile is not within `maxDistance` steps
+// (the path built by `_make_path` cannot be shorter), and remembers results
+// for reachable tiles.
+int pathfinderGetPathLength(Object* object, int tile, int maxDistance)
+{
+    if (pathfinderGetReachableDistance(object, tile, maxDistance) == -1) {
+        return 0;
+    }
+
+    if (gReachabilityPathLengths[tile] == -1) {
+        gReachabilityPathLengths[tile] = _make_path(object, object->tile, tile, nullptr, 1);
+    }
+
+    return gReachabilityPathLengths[tile];
+}
+
+static void reachabilityFieldBuild(Object* object, int maxDistance)
+{
+    ReachabilityField* field = &gReachabilityField;
+    field->object = object;
+    field->tile = object->tile;
+    field->elevation = object->elevation;
+    field->maxDistance = maxDistance;
+    field->inCombat = isInCombat();
+    field->generation = gReachabilityGeneration;
+
+    field->stamp++;
+    if (field->stamp == 0) {
+        memset(gReachabilityStamps, 0, sizeof(gReachabilityStamps));
+        field->stamp = 1;
+    }
+
+    if (!hexGridTileIsValid(object->tile)) {
+        return;
+    }
+
+    // Unit step costs, so breadth-first order is Dijkstra order.
+    int head = 0;
+    int tail = 0;
+
+    gReachabilityStamps[object->tile] = field->stamp;
+    gReachabilityDistances[object->tile] = 0;
+    gReachabilityPathLengths[object->tile] = -1;
+    gReachabilityQueue[tail++] = object->tile;
+
+    while (head < tail) {
+        int tile = gReachabilityQueue[head++];
+        int distance = gReachabilityDistances[tile];
+        if (distance >= maxDistance) {
+            continue;
+        }
+
+        for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+            int neighbor = tileGetTileInDirection(tile, rotation, 1);
+            if (!hexGridTileIsValid(neighbor) || gReachabilityStamps[neighbor] == field->stamp) {
+                continue;
+            }
+
+            Object* obstacle = _obj_blocking_at(object, neighbor, object->elevation);
+            if (obstacle != nullptr && !canUseDoor(object, obstacle)) {
+                continue;
+            }
+
+            gReachabilityStamps[neighbor] = field->stamp;
+            gReachabilityDistances[neighbor] = distance + 1;
+            gReachabilityPathLengths[neighbor] = -1;
+            gReachabilityQueue[tail++] = neighbor;
+        }
+    }
+}
+
 // 0x41633C
 static int _idist(int x1, int y1, int x2, int y2)
 {
@@ -2167,7 +2375,7 @@ static int animateMoveObjectToObject(Object* from, Object* to, int actionPoints,
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[moveSadIndex]);
+    AnimationSad* sad = animationSadAt(moveSadIndex);
     // NOTE: Original code is somewhat different. Due to some kind of
     // optimization this value is either 1 or 2, which is later used in
     // subsequent calculations and rotations array lookup.
@@ -2379,7 +2587,7 @@ static int animateMoveObjectToTile(Object* obj, int tile, int elev, int actionPo
     }
 
     if (_obj_blocking_at(obj, tile, elev)) {
-        AnimationSad* sad = &(gAnimationSads[index]);
+        AnimationSad* sad = animationSadAt(index);
         sad->length--;
         if (sad->length <= 0) {
             sad->step = ANIM_COMPLETE;
@@ -2398,11 +2606,11 @@ static int animateMoveObjectToTile(Object* obj, int tile, int elev, int actionPo
 // 0x416DFC
 static int _anim_move(Object* obj, int tile, int elev, int a3, int anim, int a5, int animationSequenceIndex)
 {
-    if (gAnimationCurrentSad == ANIMATION_SAD_LIST_CAPACITY) {
+    if (!animationSadsReserve()) {
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[gAnimationCurrentSad]);
+    AnimationSad* sad = animationSadAt(gAnimationCurrentSad);
     sad->obj = obj;
 
     if (a5) {
@@ -2437,11 +2645,11 @@ static int _anim_move(Object* obj, int tile, int elev, int a3, int anim, int a5,
 // 0x416F54
 static int animateMoveObjectToTileStraight(Object* obj, int tile, int elevation, int anim, int animationSequenceIndex, int flags)
 {
-    if (gAnimationCurrentSad == ANIMATION_SAD_LIST_CAPACITY) {
+    if (!animationSadsReserve()) {
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[gAnimationCurrentSad]);
+    AnimationSad* sad = animationSadAt(gAnimationCurrentSad);
     sad->obj = obj;
     sad->flags = flags | ANIM_SAD_STRAIGHT;
     if (anim == -1) {
@@ -2479,11 +2687,11 @@ static int animateMoveObjectToTileStraight(Object* obj, int tile, int elevation,
 // 0x41712C
 static int _anim_move_on_stairs(Object* obj, int tile, int elevation, int anim, int animationSequenceIndex)
 {
-    if (gAnimationCurrentSad == ANIMATION_SAD_LIST_CAPACITY) {
+    if (!animationSadsReserve()) {
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[gAnimationCurrentSad]);
+    AnimationSad* sad = animationSadAt(gAnimationCurrentSad);
     sad->flags = ANIM_SAD_STRAIGHT;
     sad->obj = obj;
     if (anim == -1) {
@@ -2510,15 +2718,15 @@ static int _anim_move_on_stairs(Object* obj, int tile, int elevation, int anim,
 // 0x417248
 static int _check_for_falling(Object* obj, int anim, int a3)
 {
-    if (gAnimationCurrentSad == ANIMATION_SAD_LIST_CAPACITY) {
+    if (_check_gravity(obj->tile, obj->elevation) == obj->elevation) {
         return -1;
     }
 
-    if (_check_gravity(obj->tile, obj->elevation) == obj->elevation) {
+    if (!animationSadsReserve()) {
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[gAnimationCurrentSad]);
+    AnimationSad* sad = animationSadAt(gAnimationCurrentSad);
     sad->flags = ANIM_SAD_STRAIGHT;
     sad->obj = obj;
     if (anim == -1) {
@@ -2545,7 +2753,7 @@ static int _check_for_falling(Object* obj, int anim, int a3)
 // 0x417360
 static void _object_move(int index)
 {
-    AnimationSad* sad = &(gAnimationSads[index]);
+    AnimationSad* sad = animationSadAt(index);
     Object* object = sad->obj;
 
     Rect dirtyRect;
@@ -2666,7 +2874,7 @@ static void _object_move(int index)
 // 0x4177C0
 static void _object_straight_move(int index)
 {
-    AnimationSad* sad = &(gAnimationSads[index]);
+    AnimationSad* sad = animationSadAt(index);
     Object* object = sad->obj;
 
     Rect dirtyRect;
@@ -2721,11 +2929,11 @@ static void _object_straight_move(int index)
 // 0x4179B8
 static int _anim_animate(Object* obj, int anim, int animationSequenceIndex, int flags)
 {
-    if (gAnimationCurrentSad == ANIMATION_SAD_LIST_CAPACITY) {
+    if (!animationSadsReserve()) {
         return -1;
     }
 
-    AnimationSad* sad = &(gAnimationSads[gAnimationCurrentSad]);
+    AnimationSad* sad = animationSadAt(gAnimationCurrentSad);
 
     int fid;
     if (anim == ANIM_TAKE_OUT) {
@@ -2760,22 +2968,42 @@ void _object_animate()
         return;
     }
 
+    // CE: Nothing to do until the earliest sad is due, skip polling them.
+    unsigned int time = getTicks();
+    if (!gAnimationPassPending && getTicksBetween(time, gAnimationLastPassTime) < gAnimationNextPassDelay) {
+        gAnimationPassesSkipped++;
+        return;
+    }
+
+    gAnimationPassPending = false;
+    gAnimationLastPassTime = time;
+    gAnimationNextPassDelay = UINT_MAX;
+    gAnimationPasses++;
+
     _anim_in_bk = true;
 
     for (int index = 0; index < gAnimationCurrentSad; index++) {
-        AnimationSad* sad = &(gAnimationSads[index]);
+        AnimationSad* sad = animationSadAt(index);
         if (sad->step == ANIM_COMPLETE) {
             continue;
         }
 
         Object* object = sad->obj;
 
-        unsigned int time = getTicks();
-        if (getTicksBetween(time, sad->animationTimestamp) < sad->ticksPerFrame) {
+        unsigned int elapsed = getTicksBetween(time, sad->animationTimestamp);
+        if (elapsed < sad->ticksPerFrame) {
+            if (sad->ticksPerFrame - elapsed < gAnimationNextPassDelay) {
+                gAnimationNextPassDelay = sad->ticksPerFrame - elapsed;
+            }
             continue;
         }
 
         sad->animationTimestamp = time;
+        gAnimationSadsAdvanced++;
+
+        if (sad->ticksPerFrame < gAnimationNextPassDelay) {
+            gAnimationNextPassDelay = sad->ticksPerFrame;
+        }
 
         if (animationRunSequence(sad->animationSequenceIndex) == -1) {
             continue;
@@ -2796,7 +3024,7 @@ void _object_animate()
 
         if (sad->step == 0) {
             for (int index = 0; index < gAnimationCurrentSad; index++) {
-                AnimationSad* otherSad = &(gAnimationSads[index]);
+                AnimationSad* otherSad = animationSadAt(index);
                 if (object == otherSad->obj && otherSad->step == SAD_INIT) {
                     otherSad->step = ANIM_COMPLETE;
                     _anim_set_continue(otherSad->animationSequenceIndex, 1);
@@ -2919,13 +3147,19 @@ void _object_animate()
     _anim_in_bk = 0;
 
     _object_anim_compact();
+
+    unsigned int passTicks = getTicksSince(time);
+    gAnimationPassTicksTotal += passTicks;
+    if (passTicks > gAnimationPassTicksMax) {
+        gAnimationPassTicksMax = passTicks;
+    }
 }
 
 // 0x417F18
 static void _object_anim_compact()
 {
-    for (int index = 0; index < ANIMATION_SEQUENCE_LIST_CAPACITY; index++) {
-        AnimationSequence* animationSequence = &(gAnimationSequences[index]);
+    for (int index = 0; index < gAnimationSequenceCapacity; index++) {
+        AnimationSequence* animationSequence = animationSequenceAt(index);
         if ((animationSequence->flags & ANIM_SEQ_0x20) != 0) {
             animationSequence->flags = 0;
         }
@@ -2933,10 +3167,10 @@ static void _object_anim_compact()
 
     int index = 0;
     for (; index < gAnimationCurrentSad; index++) {
-        if (gAnimationSads[index].step == ANIM_COMPLETE) {
+        if (animationSadAt(index)->step == ANIM_COMPLETE) {
             int nextIndex = index + 1;
             for (; nextIndex < gAnimationCurrentSad; nextIndex++) {
-                if (gAnimationSads[nextIndex].step != ANIM_COMPLETE) {
+                if (animationSadAt(nextIndex)->step != ANIM_COMPLETE) {
                     break;
                 }
             }
@@ -2946,9 +3180,9 @@ static void _object_anim_compact()
             }
 
             if (index != nextIndex) {
-                memcpy(&(gAnimationSads[index]), &(gAnimationSads[nextIndex]), sizeof(AnimationSad));
-                gAnimationSads[nextIndex].step = ANIM_COMPLETE;
-                gAnimationSads[nextIndex].flags = 0;
+                memcpy(animationSadAt(index), animationSadAt(nextIndex), sizeof(AnimationSad));
+                animationSadAt(nextIndex)->step = ANIM_COMPLETE;
+                animationSadAt(nextIndex)->flags = 0;
             }
         }
     }
@@ -3214,6 +3448,7 @@ void _dude_standup(Object* a1)
     animationRegisterAnimate(a1, anim, 0);
     reg_anim_end();
     a1->data.critter.combat.results &= ~DAM_KNOCKED_DOWN;
+    combatInvalidateLineOfFireCache();
 }
 
 // 0x4185EC
@@ -3279,7 +3514,7 @@ void animationStop()
     gAnimationInStop = true;
     gAnimationSequenceCurrentIndex = -1;
 
-    for (int index = 0; index < ANIMATION_SEQUENCE_LIST_CAPACITY; index++) {
+    for (int index = 0; index < gAnimationSequenceCapacity; index++) {
         _anim_set_end(index);
     }
 
@@ -3287,6 +3522,101 @@ void animationStop()
     gAnimationCurrentSad = 0;
 }
 
+static AnimationSequence* animationSequenceAt(int index)
+{
+    return &(gAnimationSequenceChunks[index / ANIMATION_SEQUENCE_CHUNK_LENGTH][index % ANIMATION_SEQUENCE_CHUNK_LENGTH]);
+}
+
+// Adds another chunk of free sequences. Returns false if the limit is
+// reached.
+static bool animationSequencesGrow()
+{
+    int chunk = gAnimationSequenceCapacity / ANIMATION_SEQUENCE_CHUNK_LENGTH;
+    if (chunk >= ANIMATION_SEQUENCE_CHUNK_COUNT) {
+        return false;
+    }
+
+    AnimationSequence* animationSequences = (AnimationSequence*)internal_malloc(sizeof(*animationSequences) * ANIMATION_SEQUENCE_CHUNK_LENGTH);
+    if (animationSequences == nullptr) {
+        return false;
+    }
+
+    memset(animationSequences, 0, sizeof(*animationSequences) * ANIMATION_SEQUENCE_CHUNK_LENGTH);
+
+    for (int index = 0; index < ANIMATION_SEQUENCE_CHUNK_LENGTH; index++) {
+        animationSequences[index].step = ANIM_COMPLETE;
+        animationSequences[index].flags = 0;
+    }
+
+    gAnimationSequenceChunks[chunk] = animationSequences;
+    gAnimationSequenceCapacity += ANIMATION_SEQUENCE_CHUNK_LENGTH;
+
+    if (chunk != 0) {
+        debugPrint("Animations: %d sequences allocated\n", gAnimationSequenceCapacity);
+    }
+
+    return true;
+}
+
+static AnimationSad* animationSadAt(int index)
+{
+    return &(gAnimationSadChunks[index / ANIMATION_SAD_CHUNK_LENGTH][index % ANIMATION_SAD_CHUNK_LENGTH]);
+}
+
+// Makes sure there is room for a new sad at `gAnimationCurrentSad`, adding
+// another chunk if needed. Returns false if the limit is reached.
+static bool animationSadsReserve()
+{
+    if (gAnimationCurrentSad == gAnimationSadCapacity) {
+        int chunk = gAnimationSadCapacity / ANIMATION_SAD_CHUNK_LENGTH;
+        if (chunk >= ANIMATION_SAD_CHUNK_COUNT) {
+            return false;
+        }
+
+        AnimationSad* sads = (AnimationSad*)internal_malloc(sizeof(*sads) * ANIMATION_SAD_CHUNK_LENGTH);
+        if (sads == nullptr) {
+            return false;
+        }
+
+        memset(sads, 0, sizeof(*sads) * ANIMATION_SAD_CHUNK_LENGTH);
+
+        gAnimationSadChunks[chunk] = sads;
+        gAnimationSadCapacity += ANIMATION_SAD_CHUNK_LENGTH;
+
+        if (chunk != 0) {
+            debugPrint("Animations: %d sads allocated\n", gAnimationSadCapacity);
+        }
+    }
+
+    if (gAnimationCurrentSad + 1 > gAnimationSadsPeak) {
+        gAnimationSadsPeak = gAnimationCurrentSad + 1;
+    }
+
+    // New sad is due immediately.
+    gAnimationPassPending = true;
+
+    return true;
+}
+
+static void animationFreeChunks()
+{
+    for (int chunk = 0; chunk < ANIMATION_SEQUENCE_CHUNK_COUNT; chunk++) {
+        if (gAnimationSequenceChunks[chunk] != nullptr) {
+            internal_free(gAnimationSequenceChunks[chunk]);
+            gAnimationSequenceChunks[chunk] = nullptr;
+        }
+    }
+    gAnimationSequenceCapacity = 0;
+
+    for (int chunk = 0; chunk < ANIMATION_SAD_CHUNK_COUNT; chunk++) {
+        if (gAnimationSadChunks[chunk] != nullptr) {
+            internal_free(gAnimationSadChunks[chunk]);
+            gAnimationSadChunks[chunk] = nullptr;
+        }
+    }
+    gAnimationSadCapacity = 0;
+}
+
 // 0x418708
 static int _check_gravity(int tile, int elevation)
 {
@@ -3336,7 +3666,7 @@ int animationRegisterSetLightIntensity(Object* owner, int lightDistance, int lig
         return -1;
     }
 
-    AnimationSequence* animationSequence = &(gAnimationSequences[gAnimationSequenceCurrentIndex]);
+    AnimationSequence* animationSequence = animationSequenceAt(gAnimationSequenceCurrentIndex);
     AnimationDescription* animationDescription = &(animationSequence->animations[gAnimationDescriptionCurrentIndex]);
     animationDescription->kind = ANIM_KIND_SET_LIGHT_INTENSITY;
     animationDescription->artCacheKey = nullptr;
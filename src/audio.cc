@@ -9,6 +9,7 @@
 #include "memory_manager.h"
 #include "sound.h"
 #include "sound_decoder.h"
+#include "sound_decoder_worker.h"
 
 namespace fallout {
 
@@ -21,6 +22,7 @@ typedef struct Audio {
     int flags;
     File* stream;
     SoundDecoder* soundDecoder;
+    SoundDecoderStream* soundDecoderStream;
     int fileSize;
     int sampleRate;
     int channels;
@@ -53,7 +55,9 @@ static bool defaultCompressionFunc(char* filePath)
 // 0x41A2D0
 static int audioSoundDecoderReadHandler(void* data, void* buffer, unsigned int size)
 {
-    return fileRead(buffer, 1, size, reinterpret_cast<File*>(data));
+    // CE: Bypass `fileRead` - it reports read progress to the loading screen,
+    // and this handler can be called from the sound decoder worker thread.
+    return xfileRead(buffer, 1, size, reinterpret_cast<File*>(data));
 }
 
 // AudioOpen
@@ -99,6 +103,7 @@ int audioOpen(const char* fname, int* sampleRate)
     if (compression == 2) {
         audioFile->flags |= AUDIO_COMPRESSED;
         audioFile->soundDecoder = soundDecoderInit(audioSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+        audioFile->soundDecoderStream = soundDecoderStreamOpen(audioFile->soundDecoder, SOUND_DECODER_STREAM_DEFAULT_LATENCY);
         audioFile->fileSize *= 2;
 
         *sampleRate = audioFile->sampleRate;
@@ -115,12 +120,18 @@ int audioOpen(const char* fname, int* sampleRate)
 int audioClose(int handle)
 {
     Audio* audioFile = &(gAudioList[handle - 1]);
-    fileClose(audioFile->stream);
-
+    // CE: Close decoder stream before the file, its worker might still be
+    // reading from it.
     if ((audioFile->flags & AUDIO_COMPRESSED) != 0) {
+        if (audioFile->soundDecoderStream != nullptr) {
+            soundDecoderStreamClose(audioFile->soundDecoderStream);
+        }
+
         soundDecoderFree(audioFile->soundDecoder);
     }
 
+    fileClose(audioFile->stream);
+
     memset(audioFile, 0, sizeof(Audio));
 
     return 0;
@@ -133,7 +144,11 @@ int audioRead(int handle, void* buffer, unsigned int size)
 
     int bytesRead;
     if ((audioFile->flags & AUDIO_COMPRESSED) != 0) {
-        bytesRead = soundDecoderDecode(audioFile->soundDecoder, buffer, size);
+        if (audioFile->soundDecoderStream != nullptr) {
+            bytesRead = soundDecoderStreamRead(audioFile->soundDecoderStream, buffer, size);
+        } else {
+            bytesRead = soundDecoderDecode(audioFile->soundDecoder, buffer, size);
+        }
     } else {
         bytesRead = fileRead(buffer, 1, size, audioFile->stream);
     }
@@ -168,9 +183,14 @@ long audioSeek(int handle, long offset, int origin)
 
     if ((audioFile->flags & AUDIO_COMPRESSED) != 0) {
         if (pos < audioFile->position) {
+            if (audioFile->soundDecoderStream != nullptr) {
+                soundDecoderStreamClose(audioFile->soundDecoderStream);
+            }
+
             soundDecoderFree(audioFile->soundDecoder);
             fileSeek(audioFile->stream, 0, SEEK_SET);
             audioFile->soundDecoder = soundDecoderInit(audioSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+            audioFile->soundDecoderStream = soundDecoderStreamOpen(audioFile->soundDecoder, SOUND_DECODER_STREAM_DEFAULT_LATENCY);
             audioFile->position = 0;
             audioFile->fileSize *= 2;
 
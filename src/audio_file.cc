@@ -9,6 +9,7 @@
 #include "platform_compat.h"
 #include "sound.h"
 #include "sound_decoder.h"
+#include "sound_decoder_worker.h"
 
 namespace fallout {
 
@@ -21,6 +22,7 @@ typedef struct AudioFile {
     int flags;
     FILE* stream;
     SoundDecoder* soundDecoder;
+    SoundDecoderStream* soundDecoderStream;
     int fileSize;
     int sampleRate;
     int channels;
@@ -97,6 +99,7 @@ int audioFileOpen(const char* fname, int* sampleRate)
     if (compression == 2) {
         audioFile->flags |= AUDIO_FILE_COMPRESSED;
         audioFile->soundDecoder = soundDecoderInit(audioFileSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+        audioFile->soundDecoderStream = soundDecoderStreamOpen(audioFile->soundDecoder, SOUND_DECODER_STREAM_DEFAULT_LATENCY);
         audioFile->fileSize *= 2;
 
         *sampleRate = audioFile->sampleRate;
@@ -113,12 +116,18 @@ int audioFileOpen(const char* fname, int* sampleRate)
 int audioFileClose(int handle)
 {
     AudioFile* audioFile = &(gAudioFileList[handle - 1]);
-    fclose(audioFile->stream);
-
+    // CE: Close decoder stream before the file, its worker might still be
+    // reading from it.
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
+        if (audioFile->soundDecoderStream != nullptr) {
+            soundDecoderStreamClose(audioFile->soundDecoderStream);
+        }
+
         soundDecoderFree(audioFile->soundDecoder);
     }
 
+    fclose(audioFile->stream);
+
     // Reset audio file (which also resets it's use flag).
     memset(audioFile, 0, sizeof(*audioFile));
 
@@ -133,7 +142,11 @@ int audioFileRead(int handle, void* buffer, unsigned int size)
 
     int bytesRead;
     if ((ptr->flags & AUDIO_FILE_COMPRESSED) != 0) {
-        bytesRead = soundDecoderDecode(ptr->soundDecoder, buffer, size);
+        if (ptr->soundDecoderStream != nullptr) {
+            bytesRead = soundDecoderStreamRead(ptr->soundDecoderStream, buffer, size);
+        } else {
+            bytesRead = soundDecoderDecode(ptr->soundDecoder, buffer, size);
+        }
     } else {
         bytesRead = fread(buffer, 1, size, ptr->stream);
     }
@@ -168,11 +181,16 @@ long audioFileSeek(int handle, long offset, int origin)
 
     if ((audioFile->flags & AUDIO_FILE_COMPRESSED) != 0) {
         if (a4 <= audioFile->position) {
+            if (audioFile->soundDecoderStream != nullptr) {
+                soundDecoderStreamClose(audioFile->soundDecoderStream);
+            }
+
             soundDecoderFree(audioFile->soundDecoder);
 
             fseek(audioFile->stream, 0, 0);
 
             audioFile->soundDecoder = soundDecoderInit(audioFileSoundDecoderReadHandler, audioFile->stream, &(audioFile->channels), &(audioFile->sampleRate), &(audioFile->fileSize));
+            audioFile->soundDecoderStream = soundDecoderStreamOpen(audioFile->soundDecoder, SOUND_DECODER_STREAM_DEFAULT_LATENCY);
             audioFile->fileSize *= 2;
             audioFile->position = 0;
 
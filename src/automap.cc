@@ -37,6 +37,15 @@ namespace fallout {
 #define AUTOMAP_PIPBOY_VIEW_X (238)
 #define AUTOMAP_PIPBOY_VIEW_Y (105)
 
+// Size of entry header (data size and compression flag).
+#define AUTOMAP_ENTRY_HEADER_SIZE (5)
+
+// CE: The largest entry (uncompressed data).
+#define AUTOMAP_ENTRY_MAX_SIZE (AUTOMAP_ENTRY_HEADER_SIZE + SQUARE_GRID_SIZE)
+
+// CE: Number of decoded entries kept for rendering in Pipboy.
+#define AUTOMAP_CACHE_SIZE (6)
+
 static void automapRenderInMapWindow(int window, int elevation, unsigned char* backgroundData, int flags);
 static int automapSaveEntry(File* stream);
 static int automapLoadEntry(int map, int elevation);
@@ -44,7 +53,9 @@ static int automapSaveHeader(File* stream);
 static int automapLoadHeader(File* stream);
 static void _decode_map_data(int elevation);
 static int automapCreate();
-static int _copy_file_data(File* stream1, File* stream2, int length);
+static int automapGetEntryCapacity(int entryOffset);
+static unsigned char* automapCacheGet(int map, int elevation);
+static void automapCacheRemove(int map, int elevation);
 
 typedef enum AutomapFrm {
     AUTOMAP_FRM_BACKGROUND,
@@ -62,6 +73,13 @@ typedef struct AutomapEntry {
     unsigned char* data;
 } AutomapEntry;
 
+typedef struct AutomapCacheEntry {
+    int map;
+    int elevation;
+    unsigned int lastUsed;
+    unsigned char data[SQUARE_GRID_SIZE];
+} AutomapCacheEntry;
+
 // 0x41ADE0
 static const int _defam[AUTOMAP_MAP_COUNT][ELEVATION_COUNT] = {
     { -1, -1, -1 },
@@ -251,6 +269,10 @@ static AutomapHeader gAutomapHeader;
 // 0x56D2A0
 static AutomapEntry gAutomapEntry;
 
+// CE: Decoded entries of automap database, `lastUsed` is 0 for unused entries.
+static AutomapCacheEntry gAutomapCache[AUTOMAP_CACHE_SIZE];
+static unsigned int gAutomapCacheClock = 0;
+
 // automap_init
 // 0x41B7F4
 int automapInit()
@@ -271,6 +293,8 @@ int automapReset()
 // 0x41B81C
 void automapExit()
 {
+    automapInvalidateCache();
+
     char path[COMPAT_MAX_PATH];
     snprintf(path, sizeof(path), "%s\\%s\\%s", settings.system.master_patches_path.c_str(), "MAPS", AUTOMAP_DB);
     compat_remove(path);
@@ -628,20 +652,16 @@ int automapRenderInPipboyWindow(int window, int map, int elevation)
     unsigned char wallColor = _colorTable[992];
     unsigned char sceneryColor = _colorTable[480];
 
-    gAutomapEntry.data = (unsigned char*)internal_malloc(11024);
-    if (gAutomapEntry.data == nullptr) {
-        debugPrint("\nAUTOMAP: Error allocating data buffer!\n");
-        return -1;
-    }
-
-    if (automapLoadEntry(map, elevation) == -1) {
-        internal_free(gAutomapEntry.data);
+    // CE: Decoded entries are cached, the database is only read when the map
+    // is displayed for the first time or it was changed since.
+    unsigned char* data = automapCacheGet(map, elevation);
+    if (data == nullptr) {
         return -1;
     }
 
     int v1 = 0;
     unsigned char v2 = 0;
-    unsigned char* ptr = gAutomapEntry.data;
+    unsigned char* ptr = data;
 
     // FIXME: This loop is implemented incorrectly. Automap requires 400x400 px,
     // but it's top offset is 105, which gives max y 505. It only works because
@@ -676,8 +696,6 @@ int automapRenderInPipboyWindow(int window, int map, int elevation)
         windowBuffer += 640 + 240;
     }
 
-    internal_free(gAutomapEntry.data);
-
     return 0;
 }
 
@@ -742,116 +760,29 @@ int automapSaveCurrent()
         gAutomapEntry.isCompressed = 1;
     }
 
-    if (entryOffset != 0) {
-        snprintf(path, sizeof(path), "%s\\%s", "MAPS", AUTOMAP_TMP);
-
-        File* stream2 = fileOpen(path, "wb");
-        if (stream2 == nullptr) {
-            debugPrint("\nAUTOMAP: Error creating temp file!\n");
+    automapCacheRemove(map, elevation);
+
+    // CE: Entries are no longer moved when one of them changes size. The
+    // database is rewritten in place: when the new entry fits into the space
+    // up to the next entry it overwrites the old one, otherwise it's appended
+    // to the end with some room to grow and the old space is left to the
+    // preceding entry. The file format is unchanged, original databases
+    // (including ones from saved games) are updated the same way.
+    int entrySize = gAutomapEntry.dataSize + AUTOMAP_ENTRY_HEADER_SIZE;
+    if (entryOffset != 0 && entrySize <= automapGetEntryCapacity(entryOffset)) {
+        if (fileSeek(stream1, entryOffset, SEEK_SET) == -1) {
+            debugPrint("\nAUTOMAP: Error writing automap database entry data!\n");
             internal_free(gAutomapEntry.data);
             internal_free(gAutomapEntry.compressedData);
             fileClose(stream1);
             return -1;
         }
 
-        fileRewind(stream1);
-
-        if (_copy_file_data(stream1, stream2, entryOffset) == -1) {
-            debugPrint("\nAUTOMAP: Error copying file data!\n");
-            fileClose(stream1);
-            fileClose(stream2);
-            internal_free(gAutomapEntry.data);
-            internal_free(gAutomapEntry.compressedData);
-            return -1;
-        }
-
-        if (automapSaveEntry(stream2) == -1) {
-            fileClose(stream1);
-            internal_free(gAutomapEntry.data);
-            internal_free(gAutomapEntry.compressedData);
-            return -1;
-        }
-
-        int nextEntryDataSize;
-        if (fileReadInt32(stream1, &nextEntryDataSize) == -1) {
-            debugPrint("\nAUTOMAP: Error reading database #1!\n");
-            fileClose(stream1);
-            fileClose(stream2);
-            internal_free(gAutomapEntry.data);
-            internal_free(gAutomapEntry.compressedData);
-            return -1;
-        }
-
-        int automapDataSize = fileGetSize(stream1);
-        if (automapDataSize == -1) {
-            debugPrint("\nAUTOMAP: Error reading database #2!\n");
-            fileClose(stream1);
-            fileClose(stream2);
-            internal_free(gAutomapEntry.data);
-            internal_free(gAutomapEntry.compressedData);
-            return -1;
-        }
-
-        int nextEntryOffset = entryOffset + nextEntryDataSize + 5;
-        if (automapDataSize != nextEntryOffset) {
-            if (fileSeek(stream1, nextEntryOffset, SEEK_SET) == -1) {
-                debugPrint("\nAUTOMAP: Error writing temp data!\n");
-                fileClose(stream1);
-                fileClose(stream2);
-                internal_free(gAutomapEntry.data);
-                internal_free(gAutomapEntry.compressedData);
-                return -1;
-            }
-
-            if (_copy_file_data(stream1, stream2, automapDataSize - nextEntryOffset) == -1) {
-                debugPrint("\nAUTOMAP: Error copying file data!\n");
-                fileClose(stream1);
-                fileClose(stream2);
-                internal_free(gAutomapEntry.data);
-                internal_free(gAutomapEntry.compressedData);
-                return -1;
-            }
-        }
-
-        int diff = gAutomapEntry.dataSize - nextEntryDataSize;
-        for (int map = 0; map < AUTOMAP_MAP_COUNT; map++) {
-            for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
-                if (gAutomapHeader.offsets[map][elevation] > entryOffset) {
-                    gAutomapHeader.offsets[map][elevation] += diff;
-                }
-            }
-        }
-
-        gAutomapHeader.dataSize += diff;
-
-        if (automapSaveHeader(stream2) == -1) {
-            fileClose(stream1);
+        if (automapSaveEntry(stream1) == -1) {
             internal_free(gAutomapEntry.data);
             internal_free(gAutomapEntry.compressedData);
             return -1;
         }
-
-        fileSeek(stream2, 0, SEEK_END);
-        fileClose(stream2);
-        fileClose(stream1);
-        internal_free(gAutomapEntry.data);
-        internal_free(gAutomapEntry.compressedData);
-
-        // NOTE: Not sure about the size.
-        char automapDbPath[512];
-        snprintf(automapDbPath, sizeof(automapDbPath), "%s\\%s\\%s", settings.system.master_patches_path.c_str(), "MAPS", AUTOMAP_DB);
-        if (compat_remove(automapDbPath) != 0) {
-            debugPrint("\nAUTOMAP: Error removing database!\n");
-            return -1;
-        }
-
-        // NOTE: Not sure about the size.
-        char automapTmpPath[512];
-        snprintf(automapTmpPath, sizeof(automapTmpPath), "%s\\%s\\%s", settings.system.master_patches_path.c_str(), "MAPS", AUTOMAP_TMP);
-        if (compat_rename(automapTmpPath, automapDbPath) != 0) {
-            debugPrint("\nAUTOMAP: Error renaming database!\n");
-            return -1;
-        }
     } else {
         bool proceed = true;
         if (fileSeek(stream1, 0, SEEK_END) != -1) {
@@ -876,21 +807,35 @@ int automapSaveCurrent()
             return -1;
         }
 
-        gAutomapHeader.offsets[map][elevation] = gAutomapHeader.dataSize;
-        gAutomapHeader.dataSize += gAutomapEntry.dataSize + 5;
-
-        if (automapSaveHeader(stream1) == -1) {
-            internal_free(gAutomapEntry.data);
-            internal_free(gAutomapEntry.compressedData);
-            return -1;
+        // Explored maps only grow, reserve half as much again (zero filled)
+        // so that next saves fit into the same place.
+        int entryCapacity = std::min(entrySize + entrySize / 2, AUTOMAP_ENTRY_MAX_SIZE);
+        if (entryCapacity > entrySize) {
+            memset(gAutomapEntry.data, 0, entryCapacity - entrySize);
+            if (fileWriteUInt8List(stream1, gAutomapEntry.data, entryCapacity - entrySize) == -1) {
+                debugPrint("\nAUTOMAP: Error writing automap database entry data!\n");
+                internal_free(gAutomapEntry.data);
+                internal_free(gAutomapEntry.compressedData);
+                fileClose(stream1);
+                return -1;
+            }
         }
 
-        fileSeek(stream1, 0, SEEK_END);
-        fileClose(stream1);
+        gAutomapHeader.offsets[map][elevation] = gAutomapHeader.dataSize;
+        gAutomapHeader.dataSize += entryCapacity;
+    }
+
+    if (automapSaveHeader(stream1) == -1) {
         internal_free(gAutomapEntry.data);
         internal_free(gAutomapEntry.compressedData);
+        return -1;
     }
 
+    fileSeek(stream1, 0, SEEK_END);
+    fileClose(stream1);
+    internal_free(gAutomapEntry.data);
+    internal_free(gAutomapEntry.compressedData);
+
     return 1;
 }
 
@@ -1104,6 +1049,8 @@ static void _decode_map_data(int elevation)
 // 0x41CC98
 static int automapCreate()
 {
+    automapInvalidateCache();
+
     gAutomapHeader.version = 1;
     gAutomapHeader.dataSize = 1925;
     memcpy(gAutomapHeader.offsets, _defam, sizeof(_defam));
@@ -1126,38 +1073,81 @@ static int automapCreate()
     return 0;
 }
 
-// Copy data from stream1 to stream2.
-//
-// 0x41CD6C
-static int _copy_file_data(File* stream1, File* stream2, int length)
+// CE: Returns the number of bytes available to the entry at given offset,
+// that is up to the next entry or the end of database. Expects
+// `gAutomapHeader` to be loaded.
+static int automapGetEntryCapacity(int entryOffset)
 {
-    void* buffer = internal_malloc(0xFFFF);
-    if (buffer == nullptr) {
-        return -1;
+    int nextEntryOffset = gAutomapHeader.dataSize;
+    for (int map = 0; map < AUTOMAP_MAP_COUNT; map++) {
+        for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+            int offset = gAutomapHeader.offsets[map][elevation];
+            if (offset > entryOffset && offset < nextEntryOffset) {
+                nextEntryOffset = offset;
+            }
+        }
     }
 
-    // NOTE: Original code is slightly different, but does the same thing.
-    while (length != 0) {
-        int chunkLength = std::min(length, 0xFFFF);
+    return nextEntryOffset - entryOffset;
+}
 
-        if (fileRead(buffer, chunkLength, 1, stream1) != 1) {
-            break;
+// CE: Returns decoded automap data for given map and elevation, reading it
+// from the database if needed.
+static unsigned char* automapCacheGet(int map, int elevation)
+{
+    gAutomapCacheClock++;
+
+    AutomapCacheEntry* leastRecentlyUsed = &(gAutomapCache[0]);
+    for (int index = 0; index < AUTOMAP_CACHE_SIZE; index++) {
+        AutomapCacheEntry* cacheEntry = &(gAutomapCache[index]);
+        if (cacheEntry->map == map && cacheEntry->elevation == elevation && cacheEntry->lastUsed != 0) {
+            cacheEntry->lastUsed = gAutomapCacheClock;
+            return cacheEntry->data;
         }
 
-        if (fileWrite(buffer, chunkLength, 1, stream2) != 1) {
-            break;
+        if (cacheEntry->lastUsed < leastRecentlyUsed->lastUsed) {
+            leastRecentlyUsed = cacheEntry;
         }
+    }
 
-        length -= chunkLength;
+    gAutomapEntry.data = (unsigned char*)internal_malloc(11024);
+    if (gAutomapEntry.data == nullptr) {
+        debugPrint("\nAUTOMAP: Error allocating data buffer!\n");
+        return nullptr;
     }
 
-    internal_free(buffer);
+    if (automapLoadEntry(map, elevation) == -1) {
+        internal_free(gAutomapEntry.data);
+        return nullptr;
+    }
 
-    if (length != 0) {
-        return -1;
+    memcpy(leastRecentlyUsed->data, gAutomapEntry.data, SQUARE_GRID_SIZE);
+    leastRecentlyUsed->map = map;
+    leastRecentlyUsed->elevation = elevation;
+    leastRecentlyUsed->lastUsed = gAutomapCacheClock;
+
+    internal_free(gAutomapEntry.data);
+
+    return leastRecentlyUsed->data;
+}
+
+static void automapCacheRemove(int map, int elevation)
+{
+    for (int index = 0; index < AUTOMAP_CACHE_SIZE; index++) {
+        AutomapCacheEntry* cacheEntry = &(gAutomapCache[index]);
+        if (cacheEntry->map == map && cacheEntry->elevation == elevation) {
+            cacheEntry->lastUsed = 0;
+        }
     }
+}
 
-    return 0;
+// CE: Forgets all decoded entries. Must be called whenever automap database
+// file is replaced.
+void automapInvalidateCache()
+{
+    for (int index = 0; index < AUTOMAP_CACHE_SIZE; index++) {
+        gAutomapCache[index].lastUsed = 0;
+    }
 }
 
 // 0x41CE74
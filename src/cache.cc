@@ -33,6 +33,9 @@ static int cacheEntriesCompareByMostRecentHit(const void* a1, const void* a2);
 // 0x510938
 static int _lock_sound_ticker = 0;
 
+// CE: Storage for entries of all caches.
+static MemoryPool gCacheEntryPool = MEMORY_POOL_INITIALIZER("CacheEntry", CacheEntry, 256);
+
 // cache_init
 // 0x41FCC0
 bool cacheInit(Cache* cache, CacheSizeProc* sizeProc, CacheReadProc* readProc, CacheFreeProc* freeProc, int maxSize)
@@ -210,7 +213,7 @@ bool cachePrintStats(Cache* cache, char* dest, size_t size)
 // 0x4203AC
 static bool cacheFetchEntryForKey(Cache* cache, int key, int* indexPtr)
 {
-    CacheEntry* cacheEntry = (CacheEntry*)internal_malloc(sizeof(*cacheEntry));
+    CacheEntry* cacheEntry = (CacheEntry*)memoryPoolAlloc(&gCacheEntryPool);
     if (cacheEntry == nullptr) {
         return false;
     }
@@ -393,7 +396,7 @@ static bool cacheEntryFree(Cache* cache, CacheEntry* cacheEntry)
         heapBlockDeallocate(&(cache->heap), &(cacheEntry->heapHandleIndex));
     }
 
-    internal_free(cacheEntry);
+    memoryPoolFree(&gCacheEntryPool, cacheEntry);
 
     return true;
 }
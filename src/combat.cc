@@ -1,6 +1,7 @@
 #include "combat.h"
 
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -53,6 +54,9 @@ namespace fallout {
 #define CALLED_SHOT_WINDOW_WIDTH (504)
 #define CALLED_SHOT_WINDOW_HEIGHT (309)
 
+// CE: Number of line of fire traces remembered during combat.
+#define COMBAT_LOF_CACHE_SIZE (1024)
+
 typedef enum DamageCalculationType {
     DAMAGE_CALCULATION_TYPE_VANILLA = 0,
     DAMAGE_CALCULATION_TYPE_GLOVZ = 1,
@@ -80,6 +84,18 @@ typedef struct UnarmedHitDescription {
     bool isSecondary;
 } UnarmedHitDescription;
 
+// CE: Result of `_combat_is_shot_blocked`. Entry is valid only while its
+// generation matches `gCombatLofCacheGeneration`.
+typedef struct CombatLofCacheEntry {
+    unsigned int generation;
+    Object* sourceObj;
+    Object* targetObj;
+    int from;
+    int to;
+    bool blocked;
+    int numCrittersOnLof;
+} CombatLofCacheEntry;
+
 typedef struct DamageCalculationContext {
     Attack* attack;
     int* damagePtr;
@@ -131,6 +147,7 @@ static void _draw_loc_off(int a1, int a2);
 static void _draw_loc_on_(int a1, int a2);
 static void _draw_loc_(int eventCode, int color);
 static int calledShotSelectHitLocation(Object* critter, int* hitLocation, int hitMode);
+static bool combatTraceLineOfFire(Object* sourceObj, int from, int to, Object* targetObj, int* numCrittersOnLof);
 
 static void criticalsInit();
 static void criticalsReset();
@@ -1988,6 +2005,11 @@ static int gDamageCalculationType;
 static bool gBonusHthDamageFix;
 static bool gDisplayBonusDamage;
 
+static CombatLofCacheEntry gCombatLofCache[COMBAT_LOF_CACHE_SIZE];
+static unsigned int gCombatLofCacheGeneration = 1;
+static unsigned int gCombatLofCacheHits;
+static unsigned int gCombatLofCacheMisses;
+
 // combat_init
 // 0x420CC0
 int combatInit()
@@ -2607,6 +2629,11 @@ static void _combat_begin(Object* attacker)
 
         gCombatState |= COMBAT_STATE_0x01;
 
+        gCombatLofCacheHits = 0;
+        gCombatLofCacheMisses = 0;
+        combatInvalidateLineOfFireCache();
+        tickersAdd(combatInvalidateLineOfFireCache);
+
         tileWindowRefresh();
         gameUiDisable(0);
         gameMouseSetCursor(MOUSE_CURSOR_WAIT_WATCH);
@@ -2770,6 +2797,9 @@ static void _combat_over()
 
     tickersAdd(_dude_fidget);
 
+    tickersRemove(combatInvalidateLineOfFireCache);
+    debugPrint("\ncombat: line of fire cache: %u hits, %u misses\n", gCombatLofCacheHits, gCombatLofCacheMisses);
+
     for (int index = 0; index < _list_noncom + _list_com; index++) {
         Object* critter = _combat_list[index];
         critter->data.critter.combat.damageLastTurn = 0;
@@ -3230,6 +3260,9 @@ static int _combat_turn(Object* obj, bool a2)
 {
     _combat_turn_obj = obj;
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     attackInit(&_main_ctd, obj, nullptr, HIT_MODE_PUNCH, HIT_LOCATION_TORSO);
 
     if ((obj->data.critter.combat.results & (DAM_KNOCKED_OUT | DAM_DEAD | DAM_LOSE_TURN)) != 0) {
@@ -4820,6 +4853,8 @@ static void _set_new_results(Object* critter, int flags)
     } else {
         critter->data.critter.combat.results |= flags & (DAM_KNOCKED_OUT | DAM_KNOCKED_DOWN | DAM_CRIP | DAM_DEAD | DAM_LOSE_TURN);
     }
+
+    combatInvalidateLineOfFireCache();
 }
 
 // 0x425020
@@ -5901,6 +5936,61 @@ void _combat_highlight_change()
 //
 // 0x426CC4
 bool _combat_is_shot_blocked(Object* sourceObj, int from, int to, Object* targetObj, int* numCrittersOnLof)
+{
+    // CE: AI evaluates the same lines of fire over and over while choosing
+    // targets, weapons and hit modes. Traces are remembered until anything
+    // that might affect them changes (see `combatInvalidateLineOfFireCache`).
+    if (!isInCombat()) {
+        return combatTraceLineOfFire(sourceObj, from, to, targetObj, numCrittersOnLof);
+    }
+
+    uintptr_t hash = (reinterpret_cast<uintptr_t>(sourceObj) >> 4) * 31
+        + (reinterpret_cast<uintptr_t>(targetObj) >> 4) * 17
+        + static_cast<unsigned int>(from) * 7
+        + static_cast<unsigned int>(to);
+    CombatLofCacheEntry* entry = &(gCombatLofCache[hash % COMBAT_LOF_CACHE_SIZE]);
+    if (entry->generation == gCombatLofCacheGeneration
+        && entry->sourceObj == sourceObj
+        && entry->targetObj == targetObj
+        && entry->from == from
+        && entry->to == to) {
+        gCombatLofCacheHits++;
+    } else {
+        gCombatLofCacheMisses++;
+
+        // Number of critters is always computed, it does not affect tracing.
+        int count;
+        entry->blocked = combatTraceLineOfFire(sourceObj, from, to, targetObj, &count);
+        entry->numCrittersOnLof = count;
+        entry->generation = gCombatLofCacheGeneration;
+        entry->sourceObj = sourceObj;
+        entry->targetObj = targetObj;
+        entry->from = from;
+        entry->to = to;
+    }
+
+    if (numCrittersOnLof != nullptr) {
+        *numCrittersOnLof = entry->numCrittersOnLof;
+    }
+
+    return entry->blocked;
+}
+
+// CE: Forgets all remembered lines of fire. Must be called whenever objects
+// are moved, added, removed, shown, hidden, opened, closed, or critters die
+// or change their knockdown state. As a safety net it's also called every
+// turn and every frame during combat.
+void combatInvalidateLineOfFireCache()
+{
+    gCombatLofCacheGeneration++;
+
+    // Zero generation denotes unused entry.
+    if (gCombatLofCacheGeneration == 0) {
+        gCombatLofCacheGeneration = 1;
+    }
+}
+
+static bool combatTraceLineOfFire(Object* sourceObj, int from, int to, Object* targetObj, int* numCrittersOnLof)
 {
     if (numCrittersOnLof != nullptr) {
         *numCrittersOnLof = 0;
@@ -53,6 +53,7 @@ void _combat_outline_on();
 void _combat_outline_off();
 void _combat_highlight_change();
 bool _combat_is_shot_blocked(Object* sourceObj, int from, int to, Object* targetObj, int* numCrittersOnLof);
+void combatInvalidateLineOfFireCache();
 int _combat_player_knocked_out_by();
 int _combat_explode_scenery(Object* a1, Object* a2);
 void _combat_delete_critter(Object* obj);
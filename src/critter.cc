@@ -881,6 +881,8 @@ void critterKill(Object* critter, int anim, bool refreshRect)
 
     if (!_critter_flag_check(critter->pid, CRITTER_FLAT)) {
         critter->flags |= OBJECT_NO_BLOCK;
+        combatInvalidateLineOfFireCache();
+        pathfinderInvalidateReachability();
         _obj_toggle_flat(critter, &tempRect);
     }
 
@@ -893,6 +895,7 @@ void critterKill(Object* critter, int anim, bool refreshRect)
 
     critter->data.critter.hp = 0;
     critter->data.critter.combat.results |= DAM_DEAD;
+    combatInvalidateLineOfFireCache();
 
     if (critter->sid != -1) {
         scriptRemove(critter->sid);
@@ -1087,6 +1090,8 @@ int protoCritterDataRead(File* stream, CritterProtoData* critterData)
         critterData->damageType = DAMAGE_TYPE_NORMAL;
     }
 
+    statsInvalidateCache();
+
     return 0;
 }
 
@@ -1252,6 +1257,7 @@ int knockoutEventProcess(Object* obj, void* data)
 
     obj->data.critter.combat.results &= ~(DAM_KNOCKED_OUT | DAM_KNOCKED_DOWN);
     obj->data.critter.combat.results |= DAM_KNOCKED_DOWN;
+    combatInvalidateLineOfFireCache();
 
     if (isInCombat()) {
         obj->data.critter.combat.maneuver |= CRITTER_MANEUVER_ENGAGING;
@@ -1274,6 +1280,7 @@ int _critter_wake_clear(Object* obj, void* data)
     }
 
     obj->data.critter.combat.results &= ~(DAM_KNOCKED_OUT | DAM_KNOCKED_DOWN);
+    combatInvalidateLineOfFireCache();
 
     int fid = buildFid(FID_TYPE(obj->fid), obj->fid & 0xFFF, ANIM_STAND, (obj->fid & 0xF000) >> 12, obj->rotation + 1);
     objectSetFid(obj, fid, nullptr);
@@ -148,6 +148,12 @@ File* fileOpen(const char* filename, const char* mode)
     return xfileOpen(filename, mode);
 }
 
+// CE: Opens read-only stream over memory block, see [xfileOpenMemory].
+File* fileOpenMemory(void* data, int size)
+{
+    return xfileOpenMemory(data, size);
+}
+
 // 0x4C5ED0
 int filePrintFormatted(File* stream, const char* format, ...)
 {
@@ -18,6 +18,7 @@ int dbGetFileSize(const char* filePath, int* sizePtr);
 int dbGetFileContents(const char* filePath, void* ptr);
 int fileClose(File* stream);
 File* fileOpen(const char* filename, const char* mode);
+File* fileOpenMemory(void* data, int size);
 int filePrintFormatted(File* stream, const char* format, ...);
 int fileReadChar(File* stream);
 char* fileReadString(char* str, size_t size, File* stream);
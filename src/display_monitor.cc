@@ -94,6 +94,10 @@ static int _disp_start;
 // 0x56FB58
 static unsigned int gDisplayMonitorLastBeepTimestamp;
 
+// CE: Progress of background operation (in percents) shown as a bar along the
+// bottom edge of the monitor, -1 when there is none.
+static int gDisplayMonitorProgress = -1;
+
 static std::ofstream gConsoleFileStream;
 static int gConsoleFilePrintCount = 0;
 
@@ -374,10 +378,36 @@ static void displayMonitorRefresh()
         buf++;
     }
 
+    if (gDisplayMonitorProgress >= 0) {
+        unsigned char* progressBuf = windowGetBuffer(gInterfaceBarWindow)
+            + _intface_full_width * (DISPLAY_MONITOR_Y + DISPLAY_MONITOR_HEIGHT - 1)
+            + DISPLAY_MONITOR_X;
+        int progressWidth = DISPLAY_MONITOR_WIDTH * gDisplayMonitorProgress / 100;
+        if (progressWidth > 0) {
+            bufferFill(progressBuf, progressWidth, 1, _intface_full_width, _colorTable[992]);
+        }
+    }
+
     windowRefreshRect(gInterfaceBarWindow, &gDisplayMonitorRect);
     fontSetCurrent(oldFont);
 }
 
+// CE: Shows [progress] (0-100) of background operation, or hides it when
+// [progress] is -1.
+void displayMonitorSetProgress(int progress)
+{
+    if (progress > 100) {
+        progress = 100;
+    }
+
+    if (progress == gDisplayMonitorProgress) {
+        return;
+    }
+
+    gDisplayMonitorProgress = progress;
+    displayMonitorRefresh();
+}
+
 // 0x431B70
 static void displayMonitorScrollUpOnMouseDown(int btn, int keyCode)
 {
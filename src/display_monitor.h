@@ -9,6 +9,7 @@ void displayMonitorExit();
 void displayMonitorAddMessage(char* string);
 void displayMonitorDisable();
 void displayMonitorEnable();
+void displayMonitorSetProgress(int progress);
 
 } // namespace fallout
 
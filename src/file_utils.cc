@@ -7,13 +7,48 @@
 #include <string.h>
 #include <zlib.h>
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "platform_compat.h"
 
 namespace fallout {
 
+typedef enum FileCopyBatchOperation {
+    FILE_COPY_BATCH_OPERATION_WRITE,
+    FILE_COPY_BATCH_OPERATION_WRITE_COMPRESSED,
+    FILE_COPY_BATCH_OPERATION_RENAME,
+} FileCopyBatchOperation;
+
+typedef struct FileCopyBatchEntry {
+    FileCopyBatchOperation operation;
+    std::string existingFilePath;
+    std::string newFilePath;
+    std::vector<unsigned char> data;
+} FileCopyBatchEntry;
+
+// Set of file operations prepared on the calling thread and performed in the
+// background. Source files are read into memory when they are added, so they
+// can be freely changed or removed once `fileCopyBatchAdd*` returns.
+struct FileCopyBatch {
+    std::vector<FileCopyBatchEntry> entries;
+    std::thread thread;
+    int result;
+    // Total size of snapshots and the number of bytes written so far, used
+    // to report progress.
+    size_t totalSize;
+    std::atomic<size_t> writtenSize;
+    // Set by the worker once all entries are processed (or one of them
+    // failed), `result` is valid afterwards.
+    std::atomic<bool> done;
+};
+
 static void fileCopy(const char* existingFilePath, const char* newFilePath);
+static void fileCopyBatchRun(FileCopyBatch* batch);
+static int fileCopyBatchRunEntries(FileCopyBatch* batch);
 
 // 0x452740
 int fileCopyDecompressed(const char* existingFilePath, const char* newFilePath)
@@ -180,4 +215,159 @@ static void fileCopy(const char* existingFilePath, const char* newFilePath)
     }
 }
 
+FileCopyBatch* fileCopyBatchCreate()
+{
+    FileCopyBatch* batch = new FileCopyBatch();
+    batch->result = 0;
+    batch->totalSize = 0;
+    batch->writtenSize = 0;
+    batch->done = false;
+    return batch;
+}
+
+// Same as `fileCopyCompressed`, but only reads existing file, compression
+// and writing are deferred until the batch is started.
+int fileCopyBatchAddCompressed(FileCopyBatch* batch, const char* existingFilePath, const char* newFilePath)
+{
+    FILE* stream = compat_fopen(existingFilePath, "rb");
+    if (stream == nullptr) {
+        return -1;
+    }
+
+    FileCopyBatchEntry entry;
+    entry.newFilePath = newFilePath;
+
+    unsigned char buffer[0x4000];
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+        entry.data.insert(entry.data.end(), buffer, buffer + bytesRead);
+    }
+
+    bool failed = ferror(stream) != 0;
+    fclose(stream);
+
+    if (failed) {
+        return -1;
+    }
+
+    // Source file is already gzipped, there is no need to do anything besides
+    // copying.
+    if (entry.data.size() >= 2 && entry.data[0] == 0x1F && entry.data[1] == 0x8B) {
+        entry.operation = FILE_COPY_BATCH_OPERATION_WRITE;
+    } else {
+        entry.operation = FILE_COPY_BATCH_OPERATION_WRITE_COMPRESSED;
+    }
+
+    batch->totalSize += entry.data.size();
+    batch->entries.push_back(std::move(entry));
+
+    return 0;
+}
+
+// Renames file once all previously added entries are written. Not performed
+// if any of them fails.
+void fileCopyBatchAddRename(FileCopyBatch* batch, const char* existingFilePath, const char* newFilePath)
+{
+    FileCopyBatchEntry entry;
+    entry.operation = FILE_COPY_BATCH_OPERATION_RENAME;
+    entry.existingFilePath = existingFilePath;
+    entry.newFilePath = newFilePath;
+    batch->entries.push_back(std::move(entry));
+}
+
+void fileCopyBatchStart(FileCopyBatch* batch)
+{
+#if defined(__EMSCRIPTEN__)
+    // Web build is compiled without threads support.
+    fileCopyBatchRun(batch);
+#else
+    batch->thread = std::thread(fileCopyBatchRun, batch);
+#endif
+}
+
+// Returns true if background part of the batch is finished, so that
+// `fileCopyBatchWait` returns without blocking.
+bool fileCopyBatchIsDone(FileCopyBatch* batch)
+{
+    return batch->done;
+}
+
+// Returns percentage of snapshot data written so far.
+int fileCopyBatchGetProgress(FileCopyBatch* batch)
+{
+    if (batch->totalSize == 0) {
+        return batch->done ? 100 : 0;
+    }
+
+    return static_cast<int>(batch->writtenSize * 100 / batch->totalSize);
+}
+
+// Waits for batch to complete and frees it. Returns -1 if any of the
+// operations failed.
+int fileCopyBatchWait(FileCopyBatch* batch)
+{
+    if (batch->thread.joinable()) {
+        batch->thread.join();
+    }
+
+    int result = batch->result;
+    delete batch;
+
+    return result;
+}
+
+static void fileCopyBatchRun(FileCopyBatch* batch)
+{
+    batch->result = fileCopyBatchRunEntries(batch);
+    batch->done = true;
+}
+
+static int fileCopyBatchRunEntries(FileCopyBatch* batch)
+{
+    for (FileCopyBatchEntry& entry : batch->entries) {
+        switch (entry.operation) {
+        case FILE_COPY_BATCH_OPERATION_WRITE:
+            if (1) {
+                FILE* stream = compat_fopen(entry.newFilePath.c_str(), "wb");
+                if (stream == nullptr) {
+                    return -1;
+                }
+
+                size_t bytesWritten = fwrite(entry.data.data(), 1, entry.data.size(), stream);
+                if (fclose(stream) != 0 || bytesWritten != entry.data.size()) {
+                    return -1;
+                }
+            }
+            break;
+        case FILE_COPY_BATCH_OPERATION_WRITE_COMPRESSED:
+            if (1) {
+                gzFile stream = compat_gzopen(entry.newFilePath.c_str(), "wb");
+                if (stream == nullptr) {
+                    return -1;
+                }
+
+                int bytesWritten = entry.data.empty()
+                    ? 0
+                    : gzwrite(stream, entry.data.data(), static_cast<unsigned int>(entry.data.size()));
+                if (gzclose(stream) != Z_OK || bytesWritten != static_cast<int>(entry.data.size())) {
+                    return -1;
+                }
+            }
+            break;
+        case FILE_COPY_BATCH_OPERATION_RENAME:
+            if (compat_rename(entry.existingFilePath.c_str(), entry.newFilePath.c_str()) != 0) {
+                return -1;
+            }
+            break;
+        }
+
+        batch->writtenSize += entry.data.size();
+
+        // Release snapshot as soon as it's written.
+        std::vector<unsigned char>().swap(entry.data);
+    }
+
+    return 0;
+}
+
 } // namespace fallout
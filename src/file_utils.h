@@ -7,6 +7,16 @@ int fileCopyDecompressed(const char* existingFilePath, const char* newFilePath);
 int fileCopyCompressed(const char* existingFilePath, const char* newFilePath);
 int _gzdecompress_file(const char* existingFilePath, const char* newFilePath);
 
+typedef struct FileCopyBatch FileCopyBatch;
+
+FileCopyBatch* fileCopyBatchCreate();
+int fileCopyBatchAddCompressed(FileCopyBatch* batch, const char* existingFilePath, const char* newFilePath);
+void fileCopyBatchAddRename(FileCopyBatch* batch, const char* existingFilePath, const char* newFilePath);
+void fileCopyBatchStart(FileCopyBatch* batch);
+bool fileCopyBatchIsDone(FileCopyBatch* batch);
+int fileCopyBatchGetProgress(FileCopyBatch* batch);
+int fileCopyBatchWait(FileCopyBatch* batch);
+
 } // namespace fallout
 
 #endif /* FILE_UTILS_H */
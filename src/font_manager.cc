@@ -28,9 +28,16 @@ typedef struct InterfaceFontDescriptor {
     short field_A;
     InterfaceFontGlyph glyphs[256];
     unsigned char* data;
+
+    // CE: Spans of visible pixels, see |interfaceFontBuildRuns|.
+    unsigned short* runs;
+
+    // CE: Offsets into |runs| for every glyph.
+    int runOffsets[256];
 } InterfaceFontDescriptor;
 
 static int interfaceFontLoad(int font);
+static int interfaceFontBuildRuns(InterfaceFontDescriptor* fontDescriptor, int dataSize);
 static void interfaceFontSetCurrentImpl(int font);
 static int interfaceFontGetLineHeightImpl();
 static int interfaceFontGetStringWidthImpl(const char* string);
@@ -111,6 +118,11 @@ void interfaceFontsExit()
         if (gInterfaceFontDescriptors[font].data != nullptr) {
             internal_free_safe(gInterfaceFontDescriptors[font].data, __FILE__, __LINE__); // FONTMGR.C, 124
         }
+
+        if (gInterfaceFontDescriptors[font].runs != nullptr) {
+            internal_free_safe(gInterfaceFontDescriptors[font].runs, __FILE__, __LINE__);
+            gInterfaceFontDescriptors[font].runs = nullptr;
+        }
     }
 }
 
@@ -216,6 +228,77 @@ static int interfaceFontLoad(int font_index)
     }
 
     fileClose(stream);
+
+    if (interfaceFontBuildRuns(fontDescriptor, glyphDataSize) == -1) {
+        internal_free_safe(fontDescriptor->data, __FILE__, __LINE__);
+        return -1;
+    }
+
+    return 0;
+}
+
+// CE: Collects horizontal spans of non-transparent pixels of every glyph, so
+// blank pixels (which blend to the destination as is) are skipped when
+// drawing.
+//
+// Runs of every glyph are stored row by row: number of runs in a row followed
+// by x offset and length of every run.
+static int interfaceFontBuildRuns(InterfaceFontDescriptor* fontDescriptor, int dataSize)
+{
+    fontDescriptor->runs = nullptr;
+
+    // Two passes: the first one measures, the second one fills runs.
+    for (int pass = 0; pass < 2; pass++) {
+        int runsLength = 0;
+        for (int index = 0; index < 256; index++) {
+            InterfaceFontGlyph* glyph = &(fontDescriptor->glyphs[index]);
+
+            if (pass == 1) {
+                fontDescriptor->runOffsets[index] = runsLength;
+            }
+
+            for (int y = 0; y < glyph->height; y++) {
+                int countIndex = runsLength++;
+                int count = 0;
+
+                int x = 0;
+                while (x < glyph->width) {
+                    // Treat malformed glyphs pointing outside of data as
+                    // blank.
+                    int offset = glyph->offset + y * glyph->width + x;
+                    if (offset < 0 || offset >= dataSize || fontDescriptor->data[offset] == 0) {
+                        x++;
+                        continue;
+                    }
+
+                    int start = x;
+                    while (x < glyph->width && offset < dataSize && fontDescriptor->data[offset] != 0) {
+                        x++;
+                        offset++;
+                    }
+
+                    if (pass == 1) {
+                        fontDescriptor->runs[runsLength] = start;
+                        fontDescriptor->runs[runsLength + 1] = x - start;
+                    }
+                    runsLength += 2;
+                    count++;
+                }
+
+                if (pass == 1) {
+                    fontDescriptor->runs[countIndex] = count;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            fontDescriptor->runs = (unsigned short*)internal_malloc_safe(sizeof(*fontDescriptor->runs) * (runsLength + 1), __FILE__, __LINE__);
+            if (fontDescriptor->runs == nullptr) {
+                return -1;
+            }
+        }
+    }
+
     return 0;
 }
 
@@ -385,14 +468,21 @@ static void interfaceFontDrawImpl(unsigned char* buf, const char* string, int le
         // Skip blank pixels (difference between font's line height and glyph height).
         ptr += (gCurrentInterfaceFontDescriptor->maxHeight - glyph->height) * pitch;
 
+        // CE: Blend only visible spans.
+        unsigned short* runs = gCurrentInterfaceFontDescriptor->runs + gCurrentInterfaceFontDescriptor->runOffsets[ch];
         for (int y = 0; y < glyph->height; y++) {
-            for (int x = 0; x < glyph->width; x++) {
-                unsigned char byte = *glyphDataPtr++;
-
-                *ptr++ = palette[(byte << 8) + *ptr];
+            int count = *runs++;
+            for (int run = 0; run < count; run++) {
+                unsigned char* src = glyphDataPtr + runs[0];
+                unsigned char* dest = ptr + runs[0];
+                for (int x = 0; x < runs[1]; x++) {
+                    dest[x] = palette[(src[x] << 8) + dest[x]];
+                }
+                runs += 2;
             }
 
-            ptr += pitch - glyph->width;
+            glyphDataPtr += glyph->width;
+            ptr += pitch;
         }
 
         ptr = end;
@@ -450,8 +450,12 @@ void gameExit()
 {
     debugPrint("\nGame Exit\n");
 
+    // CE: Wait for pending background save.
+    lsgExit();
+
     // SFALL
     sfall_gl_scr_exit();
+    sfall_ini_exit();
     sfallArraysExit();
     sfallListsExit();
     sfall_gl_vars_exit();
@@ -498,6 +502,10 @@ void gameExit()
     dbExit();
     settingsExit(true);
     sfallConfigExit();
+
+    // CE: Report allocator stats.
+    mem_check();
+    memoryFrameExit();
 }
 
 // 0x442D44
@@ -19,6 +19,7 @@
 #include "interface.h"
 #include "item.h"
 #include "kb.h"
+#include "map.h"
 #include "mouse.h"
 #include "object.h"
 #include "perk.h"
@@ -323,6 +324,7 @@ static int _gmouse_3d_move_to(int x, int y, int elevation, Rect* rect);
 static int gameMouseHandleScrolling(int x, int y, int cursor);
 static int objectIsDoor(Object* object);
 static bool gameMouseClickOnInterfaceBar();
+static void gameMousePreloadExitGridMap(int tile, int elevation);
 
 static void customMouseModeFrmsInit();
 
@@ -805,7 +807,19 @@ void gameMouseRefresh()
 
         char formattedActionPoints[8];
         int color;
-        int distance = _make_path(gDude, gDude->tile, gGameMouseHexCursor->tile, nullptr, 1);
+        int distance;
+        if (isInCombat()) {
+            // CE: Tiles farther than remaining action points allow are
+            // rejected by reachability field instead of full path search.
+            int maxDistance = 0;
+            while (maxDistance < 800 && critterGetMovementPointCostAdjustedForCrippledLegs(gDude, maxDistance + 1) - _combat_free_move <= gDude->data.critter.combat.ap) {
+                maxDistance++;
+            }
+            distance = pathfinderGetPathLength(gDude, gGameMouseHexCursor->tile, maxDistance);
+        } else {
+            distance = _make_path(gDude, gDude->tile, gGameMouseHexCursor->tile, nullptr, 1);
+        }
+
         if (distance != 0) {
             if (!isInCombat()) {
                 formattedActionPoints[0] = '\0';
@@ -893,6 +907,21 @@ bool gameMouseClickOnInterfaceBar()
     return _mouse_click_in(interfaceBarWindowRectLeft, interfaceBarWindowRect.top, interfaceBarWindowRectRight, interfaceBarWindowRect.bottom);
 }
 
+// CE: Preloads map which exit grid at [tile] leads to.
+static void gameMousePreloadExitGridMap(int tile, int elevation)
+{
+    if (tile == -1) {
+        return;
+    }
+
+    for (Object* obj = objectFindFirstAtLocation(elevation, tile); obj != nullptr; obj = objectFindNextAtLocation()) {
+        if ((obj->flags & OBJECT_HIDDEN) == 0 && isExitGridPid(obj->pid)) {
+            mapPreload(obj->data.misc.map);
+            break;
+        }
+    }
+}
+
 // 0x44BFA8
 void _gmouse_handle_event(int mouseX, int mouseY, int mouseState)
 {
@@ -932,6 +961,10 @@ void _gmouse_handle_event(int mouseX, int mouseY, int mouseState)
                 actionPoints = _combat_free_move + gDude->data.critter.combat.ap;
             } else {
                 actionPoints = -1;
+
+                // CE: Start loading destination map while the player walks
+                // to the exit grid.
+                gameMousePreloadExitGridMap(gGameMouseHexCursor->tile, gElevation);
             }
 
             if (gPressedPhysicalKeys[SDL_SCANCODE_LSHIFT] || gPressedPhysicalKeys[SDL_SCANCODE_RSHIFT]) {
@@ -22,6 +22,7 @@
 #include "random.h"
 #include "settings.h"
 #include "sfall_config.h"
+#include "sound_decoder_worker.h"
 #include "sound_effects_cache.h"
 #include "stat.h"
 #include "svga.h"
@@ -242,6 +243,13 @@ int gameSoundInit()
     audioFileInit(gameSoundIsCompressed);
     audioInit(gameSoundIsCompressed);
 
+    // CE: Decode music and speech ahead of playback on background threads.
+    if (!soundDecoderWorkerInit()) {
+        if (gGameSoundDebugEnabled) {
+            debugPrint("Sound decoder worker is not available, streams are decoded synchronously.\n");
+        }
+    }
+
     int cacheSize = settings.sound.cache_size;
     if (cacheSize >= 0x40000) {
         debugPrint("\n!!! Config file needs adustment.  Please remove the ");
@@ -393,6 +401,14 @@ int gameSoundExit()
     audioFileExit();
     audioExit();
 
+    if (gGameSoundDebugEnabled) {
+        SoundDecoderWorkerStats stats;
+        soundDecoderWorkerGetStats(&stats);
+        debugPrint("Sound decoder worker: %u blocks decoded, %u underruns.\n", stats.blocksDecoded, stats.underruns);
+    }
+
+    soundDecoderWorkerExit();
+
     internal_free(_sound_music_path1);
     internal_free(_sound_music_path2);
 
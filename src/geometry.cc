@@ -8,17 +8,16 @@
 
 namespace fallout {
 
+// CE: Nodes are recycled through a pool instead of a hand-rolled free list
+// refilled with |internal_malloc|.
+//
 // 0x51DEF4
-static RectListNode* _rectList = nullptr;
+static MemoryPool gRectListNodePool = MEMORY_POOL_INITIALIZER("RectListNode", RectListNode, 256);
 
 // 0x4C6900
 void _GNW_rect_exit()
 {
-    while (_rectList != nullptr) {
-        RectListNode* next = _rectList->next;
-        internal_free(_rectList);
-        _rectList = next;
-    }
+    memoryPoolExit(&gRectListNodePool);
 }
 
 // 0x4C6924
@@ -39,8 +38,8 @@ void _rect_clip_list(RectListNode** rectListNodePtr, Rect* rect)
 
             *rectListNodePtr = rectListNode->next;
 
-            rectListNode->next = _rectList;
-            _rectList = rectListNode;
+            // NOTE: Uninline.
+            _rect_free(rectListNode);
 
             if (v2.top < v1.top) {
                 RectListNode* newRectListNode = _rect_malloc();
@@ -166,33 +165,13 @@ RectListNode* rect_clip(Rect* b, Rect* t)
 // 0x4C6BB8
 RectListNode* _rect_malloc()
 {
-    if (_rectList == nullptr) {
-        for (int index = 0; index < 10; index++) {
-            RectListNode* rectListNode = (RectListNode*)internal_malloc(sizeof(*rectListNode));
-            if (rectListNode == nullptr) {
-                break;
-            }
-
-            // NOTE: Uninline.
-            _rect_free(rectListNode);
-        }
-    }
-
-    if (_rectList == nullptr) {
-        return nullptr;
-    }
-
-    RectListNode* rectListNode = _rectList;
-    _rectList = _rectList->next;
-
-    return rectListNode;
+    return (RectListNode*)memoryPoolAlloc(&gRectListNodePool);
 }
 
 // 0x4C6C04
 void _rect_free(RectListNode* rectListNode)
 {
-    rectListNode->next = _rectList;
-    _rectList = rectListNode;
+    memoryPoolFree(&gRectListNodePool, rectListNode);
 }
 
 // Calculates a union of two source rectangles and places it into result
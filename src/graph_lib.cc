@@ -10,36 +10,23 @@
 
 namespace fallout {
 
-static void _InitTree();
-static void _InsertNode(int a1);
-static void _DeleteNode(int a1);
+// CE: LZSS parameters. The bitstream is the same as produced by original
+// compressor: 4 KB ring buffer initially filled with spaces, matches of 3 to
+// 18 bytes.
+#define LZSS_RING_SIZE 4096
+#define LZSS_RING_MASK (LZSS_RING_SIZE - 1)
+#define LZSS_MIN_MATCH 3
+#define LZSS_MAX_MATCH 18
+#define LZSS_RING_START (LZSS_RING_SIZE - LZSS_MAX_MATCH)
 
-// 0x596D90
-static unsigned char _GreyTable[256];
-
-// 0x596E90
-static int* _dad_2;
-
-// 0x596E94
-static int _match_length;
-
-// 0x596E98
-static int _textsize;
-
-// 0x596E9C
-static int* _rson;
+// CE: Compressor match finder parameters.
+#define LZSS_HASH_SIZE 4096
+#define LZSS_MAX_CHAIN_LENGTH 256
 
-// 0x596EA0
-static int* _lson;
+static int lzssHash(const unsigned char* data);
 
-// 0x596EA4
-static unsigned char* _text_buf;
-
-// 0x596EA8
-static int _codesize;
-
-// 0x596EAC
-static int _match_position;
+// 0x596D90
+static unsigned char _GreyTable[256];
 
 // 0x44EBC0
 unsigned char HighRGB(unsigned char color)
@@ -60,353 +47,186 @@ int load_lbm_to_buf(const char* path, unsigned char* buffer, int a3, int a4, int
     return -1;
 }
 
+// Compresses `length` bytes from `src` into `dest`. Returns the size of
+// compressed data, or -1 if it's larger than `length`.
+//
+// CE: Original implementation found matches with binary search trees.
+// This one uses hash chains, which is several times faster on automap data.
+// The output can differ from the original compressor, but both decompress
+// to the same data.
+//
 // 0x44F250
-int graphCompress(unsigned char* a1, unsigned char* a2, int a3)
+int graphCompress(unsigned char* src, unsigned char* dest, int length)
 {
-    _dad_2 = nullptr;
-    _rson = nullptr;
-    _lson = nullptr;
-    _text_buf = nullptr;
-
-    // NOTE: Original code is slightly different, it uses deep nesting or a
-    // bunch of gotos.
-    _lson = (int*)internal_malloc(sizeof(*_lson) * 4104);
-    _rson = (int*)internal_malloc(sizeof(*_rson) * 4376);
-    _dad_2 = (int*)internal_malloc(sizeof(*_dad_2) * 4104);
-    _text_buf = (unsigned char*)internal_malloc(sizeof(*_text_buf) * 4122);
-
-    if (_lson == nullptr || _rson == nullptr || _dad_2 == nullptr || _text_buf == nullptr) {
+    // Input is preceded by the spaces decompressor's ring buffer is
+    // initialized with, so that positions in this buffer map directly to
+    // ring buffer positions, and matches can reference these spaces the same
+    // way. Extra zeroes at the end allow hashing last bytes.
+    int textLength = LZSS_RING_START + length;
+    unsigned char* text = (unsigned char*)internal_malloc(sizeof(*text) * (textLength + LZSS_MIN_MATCH));
+    int* head = (int*)internal_malloc(sizeof(*head) * LZSS_HASH_SIZE);
+    int* prev = (int*)internal_malloc(sizeof(*prev) * textLength);
+
+    if (text == nullptr || head == nullptr || prev == nullptr) {
         debugPrint("\nGRAPHLIB: Error allocating compression buffers!\n");
 
-        if (_dad_2 != nullptr) {
-            internal_free(_dad_2);
+        if (text != nullptr) {
+            internal_free(text);
         }
 
-        if (_rson != nullptr) {
-            internal_free(_rson);
-        }
-        if (_lson != nullptr) {
-            internal_free(_lson);
+        if (head != nullptr) {
+            internal_free(head);
         }
-        if (_text_buf != nullptr) {
-            internal_free(_text_buf);
+
+        if (prev != nullptr) {
+            internal_free(prev);
         }
 
         return -1;
     }
 
-    _InitTree();
+    memset(text, ' ', LZSS_RING_START);
+    memcpy(text + LZSS_RING_START, src, length);
+    memset(text + textLength, 0, LZSS_MIN_MATCH);
 
-    memset(_text_buf, ' ', 4078);
-
-    int count = 0;
-    int v30 = 0;
-    for (int index = 4078; index < 4096; index++) {
-        _text_buf[index] = *a1++;
-        int v8 = v30++;
-        if (v8 > a3) {
-            break;
-        }
-        count++;
+    for (int index = 0; index < LZSS_HASH_SIZE; index++) {
+        head[index] = -1;
     }
 
-    _textsize = count;
-
-    for (int index = 4077; index > 4059; index--) {
-        _InsertNode(index);
+    // Similarly to original compressor only the last run of spaces is
+    // available for matching.
+    for (int pos = LZSS_RING_START - LZSS_MAX_MATCH; pos < LZSS_RING_START; pos++) {
+        int hash = lzssHash(text + pos);
+        prev[pos] = head[hash];
+        head[hash] = pos;
     }
 
-    _InsertNode(4078);
+    // Every group is a flags byte (set bits denote literals, starting from
+    // the lowest one) followed by 8 literals or matches.
+    unsigned char group[1 + 8 * 2];
+    int groupLength = 1;
+    unsigned char mask = 1;
+    group[0] = 0;
 
-    unsigned char v29[32];
-    v29[1] = 0;
-
-    int v3 = 4078;
-    int v4 = 0;
-    int v10 = 0;
-    int v36 = 1;
-    unsigned char v41 = 1;
+    int compressedLength = 0;
     int rc = 0;
-    while (count != 0) {
-        if (count < _match_length) {
-            _match_length = count;
-        }
 
-        int v11 = v36 + 1;
-        if (_match_length > 2) {
-            v29[v36 + 1] = _match_position;
-            v29[v36 + 2] = ((_match_length - 3) | ((_match_position >> 4) & 0xF0));
-            v36 = v11 + 1;
-        } else {
-            _match_length = 1;
-            v29[1] |= v41;
-            int v13 = v36++;
-            v29[v13 + 1] = _text_buf[v3];
-        }
-
-        v41 *= 2;
-
-        if (v41 == 0) {
-            v11 = 0;
-            if (v36 != 0) {
-                for (;;) {
-                    v4++;
-                    *a2++ = v29[v11 + 1];
-                    if (v4 > a3) {
-                        rc = -1;
-                        break;
+    int pos = LZSS_RING_START;
+    while (pos < textLength) {
+        int maxMatchLength = std::min(LZSS_MAX_MATCH, textLength - pos);
+        int matchLength = 0;
+        int matchPosition = 0;
+
+        if (maxMatchLength >= LZSS_MIN_MATCH) {
+            // Source must stay in the ring buffer until the match is copied.
+            int minPosition = std::max(pos - LZSS_RING_START, 0);
+            int chainLength = LZSS_MAX_CHAIN_LENGTH;
+            int candidate = head[lzssHash(text + pos)];
+            while (candidate >= minPosition && chainLength-- > 0) {
+                // Quick reject by the byte which would make this match
+                // longer than the best one.
+                if (text[candidate + matchLength] == text[pos + matchLength]) {
+                    int candidateLength = 0;
+                    while (candidateLength < maxMatchLength && text[candidate + candidateLength] == text[pos + candidateLength]) {
+                        candidateLength++;
                     }
 
-                    v11++;
-                    if (v11 >= v36) {
-                        break;
+                    if (candidateLength > matchLength) {
+                        matchLength = candidateLength;
+                        matchPosition = candidate;
+                        if (matchLength == maxMatchLength) {
+                            break;
+                        }
                     }
                 }
-
-                if (rc == -1) {
-                    break;
-                }
+                candidate = prev[candidate];
             }
-
-            _codesize += v36;
-            v29[1] = 0;
-            v36 = 1;
-            v41 = 1;
         }
 
-        int v16;
-        int v38 = _match_length;
-        for (v16 = 0; v16 < v38; v16++) {
-            unsigned char v34 = *a1++;
-            int v17 = v30++;
-            if (v17 >= a3) {
-                break;
-            }
-
-            _DeleteNode(v10);
-
-            unsigned char* v19 = _text_buf + v10;
-            _text_buf[v10] = v34;
-
-            if (v10 < 17) {
-                v19[4096] = v34;
-            }
-
-            v3 = (v3 + 1) & 0xFFF;
-            v10 = (v10 + 1) & 0xFFF;
-            _InsertNode(v3);
+        if (matchLength >= LZSS_MIN_MATCH) {
+            int ringPosition = matchPosition & LZSS_RING_MASK;
+            group[groupLength++] = ringPosition & 0xFF;
+            group[groupLength++] = ((ringPosition >> 4) & 0xF0) | (matchLength - LZSS_MIN_MATCH);
+        } else {
+            matchLength = 1;
+            group[0] |= mask;
+            group[groupLength++] = text[pos];
         }
 
-        for (; v16 < v38; v16++) {
-            _DeleteNode(v10);
-            v3 = (v3 + 1) & 0xFFF;
-            v10 = (v10 + 1) & 0xFFF;
-            if (--count != 0) {
-                _InsertNode(v3);
-            }
+        for (int index = 0; index < matchLength; index++) {
+            int hash = lzssHash(text + pos);
+            prev[pos] = head[hash];
+            head[hash] = pos;
+            pos++;
         }
-    }
 
-    if (rc != -1) {
-        for (int v23 = 0; v23 < v36; v23++) {
-            v4++;
-            v10++;
-            *a2++ = v29[v23 + 1];
-            if (v10 > a3) {
+        mask <<= 1;
+        if (mask == 0 || pos >= textLength) {
+            if (compressedLength + groupLength > length) {
                 rc = -1;
                 break;
             }
-        }
 
-        _codesize += v36;
-    }
+            memcpy(dest + compressedLength, group, groupLength);
+            compressedLength += groupLength;
 
-    internal_free(_lson);
-    internal_free(_rson);
-    internal_free(_dad_2);
-    internal_free(_text_buf);
-
-    if (rc == -1) {
-        v4 = -1;
-    }
-
-    return v4;
-}
-
-// 0x44F5F0
-static void _InitTree()
-{
-    for (int index = 4097; index < 4353; index++) {
-        _rson[index] = 4096;
-    }
-
-    for (int index = 0; index < 4096; index++) {
-        _dad_2[index] = 4096;
-    }
-}
-
-// 0x44F63C
-static void _InsertNode(int a1)
-{
-    _lson[a1] = 4096;
-    _rson[a1] = 4096;
-    _match_length = 0;
-
-    unsigned char* v2 = _text_buf + a1;
-
-    int v21 = 4097 + _text_buf[a1];
-    int v5 = 1;
-    for (;;) {
-        int v6 = v21;
-        if (v5 < 0) {
-            if (_lson[v6] == 4096) {
-                _lson[v6] = a1;
-                _dad_2[a1] = v21;
-                return;
-            }
-            v21 = _lson[v6];
-        } else {
-            if (_rson[v6] == 4096) {
-                _rson[v6] = a1;
-                _dad_2[a1] = v21;
-                return;
-            }
-            v21 = _rson[v6];
-        }
-
-        int v9;
-        unsigned char* v10 = v2 + 1;
-        int v11 = v21 + 1;
-        for (v9 = 1; v9 < 18; v9++) {
-            v5 = *v10 - _text_buf[v11];
-            if (v5 != 0) {
-                break;
-            }
-            v10++;
-            v11++;
-        }
-
-        if (v9 > _match_length) {
-            _match_length = v9;
-            _match_position = v21;
-            if (v9 >= 18) {
-                break;
-            }
+            group[0] = 0;
+            groupLength = 1;
+            mask = 1;
         }
     }
 
-    _dad_2[a1] = _dad_2[v21];
-    _lson[a1] = _lson[v21];
-    _rson[a1] = _rson[v21];
-
-    _dad_2[_lson[v21]] = a1;
-    _dad_2[_rson[v21]] = a1;
+    internal_free(text);
+    internal_free(head);
+    internal_free(prev);
 
-    if (_rson[_dad_2[v21]] == v21) {
-        _rson[_dad_2[v21]] = a1;
-    } else {
-        _lson[_dad_2[v21]] = a1;
+    if (rc == -1) {
+        return -1;
     }
 
-    _dad_2[v21] = 4096;
+    return compressedLength;
 }
 
-// 0x44F7EC
-static void _DeleteNode(int a1)
+static int lzssHash(const unsigned char* data)
 {
-    if (_dad_2[a1] != 4096) {
-        int v5;
-        if (_rson[a1] == 4096) {
-            v5 = _lson[a1];
-        } else {
-            if (_lson[a1] == 4096) {
-                v5 = _rson[a1];
-            } else {
-                v5 = _lson[a1];
-
-                if (_rson[v5] != 4096) {
-                    do {
-                        v5 = _rson[v5];
-                    } while (_rson[v5] != 4096);
-
-                    _rson[_dad_2[v5]] = _lson[v5];
-                    _dad_2[_lson[v5]] = _dad_2[v5];
-                    _lson[v5] = _lson[a1];
-                    _dad_2[_lson[a1]] = v5;
-                }
-
-                _rson[v5] = _rson[a1];
-                _dad_2[_rson[a1]] = v5;
-            }
-        }
-
-        _dad_2[v5] = _dad_2[a1];
-
-        if (_rson[_dad_2[a1]] == a1) {
-            _rson[_dad_2[a1]] = v5;
-        } else {
-            _lson[_dad_2[a1]] = v5;
-        }
-        _dad_2[a1] = 4096;
-    }
+    return ((data[0] << 8) ^ (data[1] << 4) ^ data[2]) & (LZSS_HASH_SIZE - 1);
 }
 
+// CE: Decompresses `length` bytes from `src` into `dest`. Ring buffer is on
+// the stack, and flags are processed group by group.
+//
 // 0x44F92C
 int graphDecompress(unsigned char* src, unsigned char* dest, int length)
 {
-    _text_buf = (unsigned char*)internal_malloc(sizeof(*_text_buf) * 4122);
-    if (_text_buf == nullptr) {
-        debugPrint("\nGRAPHLIB: Error allocating decompression buffer!\n");
-        return -1;
-    }
-
-    int v8 = 4078;
-    memset(_text_buf, ' ', v8);
-
-    int v21 = 0;
-    int index = 0;
-    while (index < length) {
-        v21 >>= 1;
-        if ((v21 & 0x100) == 0) {
-            v21 = *src++;
-            v21 |= 0xFF00;
-        }
-
-        if ((v21 & 0x01) == 0) {
-            int v10 = *src++;
-            int v11 = *src++;
-
-            v10 |= (v11 & 0xF0) << 4;
-            v11 &= 0x0F;
-            v11 += 2;
-
-            for (int v16 = 0; v16 <= v11; v16++) {
-                int v17 = (v10 + v16) & 0xFFF;
-
-                unsigned char ch = _text_buf[v17];
-                _text_buf[v8] = ch;
+    unsigned char ring[LZSS_RING_SIZE];
+    memset(ring, ' ', sizeof(ring));
+
+    int ringPosition = LZSS_RING_START;
+    unsigned char* end = dest + length;
+    while (dest < end) {
+        unsigned int flags = *src++;
+        for (int bit = 0; bit < 8 && dest < end; bit++) {
+            if ((flags & 0x01) != 0) {
+                unsigned char ch = *src++;
+                ring[ringPosition] = ch;
+                ringPosition = (ringPosition + 1) & LZSS_RING_MASK;
                 *dest++ = ch;
-
-                v8 = (v8 + 1) & 0xFFF;
-
-                index++;
-                if (index >= length) {
-                    break;
+            } else {
+                int matchPosition = src[0] | ((src[1] & 0xF0) << 4);
+                int matchLength = std::min((src[1] & 0x0F) + LZSS_MIN_MATCH, (int)(end - dest));
+                src += 2;
+
+                for (int index = 0; index < matchLength; index++) {
+                    unsigned char ch = ring[(matchPosition + index) & LZSS_RING_MASK];
+                    ring[ringPosition] = ch;
+                    ringPosition = (ringPosition + 1) & LZSS_RING_MASK;
+                    *dest++ = ch;
                 }
             }
-        } else {
-            unsigned char ch = *src++;
-            _text_buf[v8] = ch;
-            *dest++ = ch;
-
-            v8 = (v8 + 1) & 0xFFF;
-
-            index++;
+            flags >>= 1;
         }
     }
 
-    internal_free(_text_buf);
-
     return 0;
 }
 
@@ -189,6 +189,9 @@ void _process_bk()
 {
     int v1;
 
+    // CE: Previous tick is over, release frame scratch.
+    memoryFrameReset();
+
     tickersExecute();
 
     _mouse_info();
@@ -23,6 +23,10 @@ typedef struct ProgramListNode {
     Program* program;
     struct ProgramListNode* next; // next
     struct ProgramListNode* prev; // prev
+
+    // CE: Value of |gInterpreterUpdateTick| when this program was last given
+    // a burst in |_updatePrograms|.
+    unsigned int updateTick;
 } ProgramListNode;
 
 static unsigned int _defaultTimerFunc();
@@ -128,6 +132,8 @@ static void _setupExternalCall(Program* program1, Program* program2, int address
 static void _doEvents();
 static void programListNodeFree(ProgramListNode* programListNode);
 static void interpreterPrintStats();
+static void interpreterRunBurst(ProgramListNode* programListNode, unsigned int tick);
+static void interpreterCheckBudget(Program* program, unsigned int startTime);
 
 // 0x50942C
 static char _aCouldnTFindPro[] = "<couldn't find proc>";
@@ -154,6 +160,17 @@ static int (*_outputFunc)(char*) = _outputStr;
 // 0x519050
 static int _cpuBurstSize = 10;
 
+// CE: Time (in ms) background programs are allowed to run per tick in
+// |_updatePrograms|, 0 - unlimited.
+static unsigned int gInterpreterUpdateBudget = 0;
+
+// CE: Number of |_updatePrograms| calls.
+static unsigned int gInterpreterUpdateTick = 0;
+
+// CE: Program list node to continue from when previous tick ran out of
+// budget.
+static ProgramListNode* gInterpreterProgramListResume = nullptr;
+
 // 0x59E230
 OpcodeHandler* gInterpreterOpcodeHandlers[OPCODE_MAX_COUNT];
 
@@ -2966,6 +2983,10 @@ static void programListNodeFree(ProgramListNode* programListNode)
 {
     ProgramListNode* tmp;
 
+    if (gInterpreterProgramListResume == programListNode) {
+        gInterpreterProgramListResume = programListNode->next;
+    }
+
     tmp = programListNode->next;
     if (tmp != nullptr) {
         tmp->prev = programListNode->prev;
@@ -2989,6 +3010,7 @@ void programListNodeCreate(Program* program)
     programListNode->program = program;
     programListNode->next = gInterpreterProgramListHead;
     programListNode->prev = nullptr;
+    programListNode->updateTick = 0;
 
     if (gInterpreterProgramListHead != nullptr) {
         gInterpreterProgramListHead->prev = programListNode;
@@ -3036,22 +3058,100 @@ void _updatePrograms()
     // (which are not used anyway).
     sfall_gl_scr_update(_cpuBurstSize);
 
+    // CE: Every program is given a burst of |_cpuBurstSize| instructions per
+    // tick as before, but once the tick exceeds |gInterpreterUpdateBudget| the
+    // remaining programs are postponed to the next tick, which starts where
+    // this one stopped. Programs in critical sections are run first and are
+    // never postponed, since |_interpret| does not leave them until the
+    // critical section is over anyway.
+    unsigned int tick = ++gInterpreterUpdateTick;
+    unsigned int startTime = getTicks();
+
+    int programsLength = 0;
     ProgramListNode* curr = gInterpreterProgramListHead;
     while (curr != nullptr) {
         ProgramListNode* next = curr->next;
-        if (curr->program != nullptr) {
-            _interpret(curr->program, _cpuBurstSize);
+        if (curr->program != nullptr && (curr->program->flags & PROGRAM_FLAG_CRITICAL_SECTION) != 0) {
+            interpreterRunBurst(curr, tick);
+        }
+        programsLength++;
+        curr = next;
+    }
+
+    curr = gInterpreterProgramListResume != nullptr ? gInterpreterProgramListResume : gInterpreterProgramListHead;
+    gInterpreterProgramListResume = nullptr;
+
+    for (int index = 0; index < programsLength && curr != nullptr; index++) {
+        ProgramListNode* next = curr->next;
+        if (next == nullptr) {
+            next = gInterpreterProgramListHead;
+        }
+
+        if (curr->updateTick != tick) {
+            interpreterRunBurst(curr, tick);
+        }
 
-            if (curr->program->exited) {
-                programListNodeFree(curr);
+        if (gInterpreterUpdateBudget != 0 && getTicksSince(startTime) >= gInterpreterUpdateBudget) {
+            if (index + 1 < programsLength) {
+                gInterpreterProgramListResume = next;
             }
+            break;
         }
+
         curr = next;
     }
+
     _doEvents();
     intLibUpdate();
 }
 
+// CE: Sets time budget (in ms) of background programs per tick, 0 -
+// unlimited.
+void interpreterSetUpdateBudget(int milliseconds)
+{
+    gInterpreterUpdateBudget = milliseconds > 0 ? milliseconds : 0;
+}
+
+// Runs single burst of a program in program list and releases it once it's
+// exited.
+static void interpreterRunBurst(ProgramListNode* programListNode, unsigned int tick)
+{
+    programListNode->updateTick = tick;
+
+    if (programListNode->program == nullptr) {
+        return;
+    }
+
+    unsigned int startTime = getTicks();
+    _interpret(programListNode->program, _cpuBurstSize);
+
+    // CE: Opcodes running modal UI (dialogs, barter, etc.) pump input loop,
+    // which updates programs again. Such bursts are expected to be long and
+    // are not reported.
+    if (gInterpreterUpdateTick == tick) {
+        interpreterCheckBudget(programListNode->program, startTime);
+    }
+
+    if (programListNode->program->exited) {
+        programListNodeFree(programListNode);
+    }
+}
+
+// CE: Reports programs which alone took longer than the whole budget.
+static void interpreterCheckBudget(Program* program, unsigned int startTime)
+{
+    if (gInterpreterUpdateBudget == 0) {
+        return;
+    }
+
+    unsigned int elapsed = getTicksSince(startTime);
+    if (elapsed > gInterpreterUpdateBudget) {
+        debugPrint("Script budget overrun: %s took %u ms\n",
+            program->name != nullptr ? program->name : "<unnamed>",
+            elapsed);
+    }
+}
+
 // 0x46E238
 void programListFree()
 {
@@ -221,6 +221,7 @@ void programListNodeCreate(Program* program);
 void runProgram(Program* program);
 Program* runScript(char* name);
 void _updatePrograms();
+void interpreterSetUpdateBudget(int milliseconds);
 void programListFree();
 void interpreterRegisterOpcode(int opcode, OpcodeHandler* handler);
 
@@ -933,6 +933,7 @@ static void opCreateObject(Program* program)
         if (scriptType == SCRIPT_TYPE_SPATIAL) {
             script->sp.built_tile = builtTileCreate(object->tile, object->elevation);
             script->sp.radius = 3;
+            scriptsInvalidateSpatialIndex();
         }
 
         object->id = scriptsNewObjectId();
@@ -2845,38 +2845,16 @@ Object* critterGetArmor(Object* critter)
 // 0x471CA0
 Object* objectGetCarriedObjectByPid(Object* obj, int pid)
 {
-    Inventory* inventory = &(obj->data.inventory);
-
-    for (int index = 0; index < inventory->length; index++) {
-        InventoryItem* inventoryItem = &(inventory->items[index]);
-        if (inventoryItem->item->pid == pid) {
-            return inventoryItem->item;
-        }
-
-        Object* found = objectGetCarriedObjectByPid(inventoryItem->item, pid);
-        if (found != nullptr) {
-            return found;
-        }
-    }
-
-    return nullptr;
+    // CE: Use index instead of walking inventory.
+    return itemFindByPid(obj, pid, nullptr);
 }
 
 // 0x471CDC
 int objectGetCarriedQuantityByPid(Object* object, int pid)
 {
-    int quantity = 0;
-
-    Inventory* inventory = &(object->data.inventory);
-    for (int index = 0; index < inventory->length; index++) {
-        InventoryItem* inventoryItem = &(inventory->items[index]);
-        if (inventoryItem->item->pid == pid) {
-            quantity += inventoryItem->quantity;
-        }
-
-        quantity += objectGetCarriedQuantityByPid(inventoryItem->item, pid);
-    }
-
+    // CE: Use index instead of walking inventory.
+    int quantity;
+    itemFindByPid(object, pid, &quantity);
     return quantity;
 }
 
@@ -3232,23 +3210,8 @@ Object* _inven_find_id(Object* obj, int id)
         return obj;
     }
 
-    Inventory* inventory = &(obj->data.inventory);
-    for (int index = 0; index < inventory->length; index++) {
-        InventoryItem* inventoryItem = &(inventory->items[index]);
-        Object* item = inventoryItem->item;
-        if (item->id == id) {
-            return item;
-        }
-
-        if (itemGetType(item) == ITEM_TYPE_CONTAINER) {
-            item = _inven_find_id(item, id);
-            if (item != nullptr) {
-                return item;
-            }
-        }
-    }
-
-    return nullptr;
+    // CE: Use index instead of walking inventory.
+    return itemFindById(obj, id);
 }
 
 // Returns inventory item at a given index.
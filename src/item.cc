@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 #include "animation.h"
@@ -41,6 +42,31 @@ namespace fallout {
 // by Sfall.
 #define BOOKS_MAX 50
 
+#define INVENTORY_CACHE_WEIGHT 0x01
+#define INVENTORY_CACHE_CAPS 0x02
+#define INVENTORY_CACHE_INDEX 0x04
+
+typedef struct InventoryIndexEntry {
+    // Slot of the first item in this inventory which either matches the key
+    // itself or contains matching item in its own inventory.
+    int slot;
+    // Total quantity of items with given pid, including nested inventories.
+    int quantity;
+} InventoryIndexEntry;
+
+// CE: Cached aggregates of a single inventory. Nested inventories have their
+// own entries, so rebuilding an entry walks only items on its own level.
+// Entries are marked dirty by inventory changes and the change is propagated
+// to owners (see |itemInvalidateInventory|).
+typedef struct InventoryCache {
+    int flags;
+    int weight;
+    int caps;
+    std::unordered_map<int, InventoryIndexEntry> pids;
+    // Items reachable through containers only, see |_inven_find_id|.
+    std::unordered_map<int, int> ids;
+} InventoryCache;
+
 static int _item_load_(File* stream);
 static void _item_compact(int inventoryItemIndex, Inventory* inventory);
 static int _item_move_func(Object* source, Object* target, Object* item, int quantity, bool force);
@@ -59,6 +85,9 @@ static void dudeSetAddiction(int drugPid);
 static void dudeClearAddiction(int drugPid);
 static bool dudeIsAddicted(int drugPid);
 
+static InventoryCache* inventoryCacheGetIndex(Object* owner);
+static void inventoryCacheBuildIndex(InventoryCache* cache, Object* owner);
+
 static void booksInit();
 static void booksInitVanilla();
 static void booksInitCustom();
@@ -187,6 +216,8 @@ static int gExplosionDamageType;
 static int gExplosionMaxTargets;
 static int gHealingItemPids[HEALING_ITEM_COUNT];
 
+static std::unordered_map<Inventory*, InventoryCache> gInventoryCaches;
+
 // 0x4770E0
 int itemsInit()
 {
@@ -216,11 +247,15 @@ void itemsReset()
 {
     // SFALL
     explosionsReset();
+
+    gInventoryCaches.clear();
 }
 
 // 0x477148
 void itemsExit()
 {
+    gInventoryCaches.clear();
+
     messageListRepositorySetStandardMessageList(STANDARD_MESSAGE_LIST_ITEM, nullptr);
     messageListFree(&gItemsMessageList);
 
@@ -360,6 +395,8 @@ int itemAdd(Object* owner, Object* itemToAdd, int quantity)
         inventory->length++;
         itemToAdd->owner = owner;
 
+        itemInvalidateInventory(owner);
+
         return 0;
     }
 
@@ -394,6 +431,8 @@ int itemAdd(Object* owner, Object* itemToAdd, int quantity)
     inventory->items[index].item = itemToAdd;
     itemToAdd->owner = owner;
 
+    itemInvalidateInventory(owner);
+
     return 0;
 }
 
@@ -446,6 +485,9 @@ int itemRemove(Object* owner, Object* itemToRemove, int quantity)
         }
     }
 
+    // CE: Nested containers are handled by recursive calls above.
+    itemInvalidateInventory(owner);
+
     if (itemToRemove->pid == PROTO_ID_STEALTH_BOY_I || itemToRemove->pid == PROTO_ID_STEALTH_BOY_II) {
         if (itemToRemove == item1 || itemToRemove == item2) {
             Object* owner = objectGetOwner(itemToRemove);
@@ -924,11 +966,23 @@ int objectGetInventoryWeight(Object* obj)
 
     int weight = 0;
 
+    // CE: Weight of items is cached, nested containers are weighed from their
+    // own caches by |itemGetWeight|. Hand and armor slots below are checked
+    // every time since they are not part of inventory while inventory screen
+    // is open.
     Inventory* inventory = &(obj->data.inventory);
-    for (int index = 0; index < inventory->length; index++) {
-        InventoryItem* inventoryItem = &(inventory->items[index]);
-        Object* item = inventoryItem->item;
-        weight += itemGetWeight(item) * inventoryItem->quantity;
+    InventoryCache* cache = &(gInventoryCaches[inventory]);
+    if ((cache->flags & INVENTORY_CACHE_WEIGHT) != 0) {
+        weight = cache->weight;
+    } else {
+        for (int index = 0; index < inventory->length; index++) {
+            InventoryItem* inventoryItem = &(inventory->items[index]);
+            Object* item = inventoryItem->item;
+            weight += itemGetWeight(item) * inventoryItem->quantity;
+        }
+
+        cache->weight = weight;
+        cache->flags |= INVENTORY_CACHE_WEIGHT;
     }
 
     if (FID_TYPE(obj->fid) == OBJ_TYPE_CRITTER) {
@@ -1035,28 +1089,148 @@ int itemGetActionPointCost(Object* obj, int hitMode, bool aiming)
 // 0x47808C
 int itemGetQuantity(Object* obj, Object* item)
 {
-    int quantity = 0;
+    if (item == nullptr) {
+        return 0;
+    }
 
-    Inventory* inventory = &(obj->data.inventory);
+    // CE: Instead of walking inventory (including containers) check that
+    // [item] is owned by [obj] directly or through containers, and look it up
+    // in its immediate owner only.
+    Object* owner = item->owner;
+    for (Object* container = owner; container != obj; container = container->owner) {
+        if (container == nullptr || itemGetType(container) != ITEM_TYPE_CONTAINER) {
+            return 0;
+        }
+    }
+
+    Inventory* inventory = &(owner->data.inventory);
     for (int index = 0; index < inventory->length; index++) {
         InventoryItem* inventoryItem = &(inventory->items[index]);
         if (inventoryItem->item == item) {
-            quantity = inventoryItem->quantity;
+            return inventoryItem->quantity;
+        }
+    }
 
-            // SFALL: Fix incorrect value being returned if there is a container
-            // item in the inventory.
-            break;
-        } else {
-            if (itemGetType(inventoryItem->item) == ITEM_TYPE_CONTAINER) {
-                quantity = itemGetQuantity(inventoryItem->item, item);
-                if (quantity > 0) {
-                    break;
-                }
-            }
+    return 0;
+}
+
+// CE: Returns first item with given [pid] in [obj]s inventory (including nested
+// inventories) and optionally total quantity of such items. See
+// |objectGetCarriedObjectByPid| and |objectGetCarriedQuantityByPid|.
+Object* itemFindByPid(Object* obj, int pid, int* quantityPtr)
+{
+    if (quantityPtr != nullptr) {
+        *quantityPtr = 0;
+    }
+
+    InventoryCache* cache = inventoryCacheGetIndex(obj);
+    auto it = cache->pids.find(pid);
+    if (it == cache->pids.end()) {
+        return nullptr;
+    }
+
+    if (quantityPtr != nullptr) {
+        *quantityPtr = it->second.quantity;
+    }
+
+    Object* item = obj->data.inventory.items[it->second.slot].item;
+    if (item->pid == pid) {
+        return item;
+    }
+
+    return itemFindByPid(item, pid, nullptr);
+}
+
+// CE: Returns item with given [id] in [obj]s inventory or nested containers.
+// See |_inven_find_id|.
+Object* itemFindById(Object* obj, int id)
+{
+    InventoryCache* cache = inventoryCacheGetIndex(obj);
+    auto it = cache->ids.find(id);
+    if (it == cache->ids.end()) {
+        return nullptr;
+    }
+
+    Object* item = obj->data.inventory.items[it->second].item;
+    if (item->id == id) {
+        return item;
+    }
+
+    return itemFindById(item, id);
+}
+
+// CE: Marks cached aggregates of [owner]s inventory as dirty, along with
+// inventories of its owners (containers are weighed as a part of their
+// owners). Must be called whenever inventory contents, quantities or anything
+// affecting weight of carried items is changed. Since inventory weight
+// affects maximum action points, stats cache is invalidated too.
+void itemInvalidateInventory(Object* owner)
+{
+    for (; owner != nullptr; owner = owner->owner) {
+        auto it = gInventoryCaches.find(&(owner->data.inventory));
+        if (it != gInventoryCaches.end()) {
+            it->second.flags = 0;
         }
     }
 
-    return quantity;
+    statsInvalidateCache();
+}
+
+// CE: Forgets cached aggregates of [inventory]. Called when inventory is freed
+// or the object is deallocated, so that cache is not reused if this address
+// is taken by another object.
+void itemFreeInventoryCache(Inventory* inventory)
+{
+    gInventoryCaches.erase(inventory);
+}
+
+static InventoryCache* inventoryCacheGetIndex(Object* owner)
+{
+    InventoryCache* cache = &(gInventoryCaches[&(owner->data.inventory)]);
+    if ((cache->flags & INVENTORY_CACHE_INDEX) == 0) {
+        cache->pids.clear();
+        cache->ids.clear();
+
+        inventoryCacheBuildIndex(cache, owner);
+        cache->flags |= INVENTORY_CACHE_INDEX;
+    }
+    return cache;
+}
+
+// Keys of nested inventories are taken from their own indexes and point to the
+// slot of the item which holds them, so walking down from the recorded slot
+// finds the same item as original depth-first lookup functions. Pids are
+// collected from every nested inventory, while ids only through containers.
+static void inventoryCacheBuildIndex(InventoryCache* cache, Object* owner)
+{
+    Inventory* inventory = &(owner->data.inventory);
+    for (int index = 0; index < inventory->length; index++) {
+        InventoryItem* inventoryItem = &(inventory->items[index]);
+        Object* item = inventoryItem->item;
+
+        InventoryIndexEntry* entry = &(cache->pids.emplace(item->pid, InventoryIndexEntry { index, 0 }).first->second);
+        entry->quantity += inventoryItem->quantity;
+
+        cache->ids.emplace(item->id, index);
+
+        if (item->data.inventory.length == 0) {
+            continue;
+        }
+
+        // NOTE: Nested cache is a separate node, it stays valid while this
+        // one is updated.
+        InventoryCache* nestedCache = inventoryCacheGetIndex(item);
+        for (auto& pair : nestedCache->pids) {
+            entry = &(cache->pids.emplace(pair.first, InventoryIndexEntry { index, 0 }).first->second);
+            entry->quantity += pair.second.quantity;
+        }
+
+        if (itemGetType(item) == ITEM_TYPE_CONTAINER) {
+            for (auto& pair : nestedCache->ids) {
+                cache->ids.emplace(pair.first, index);
+            }
+        }
+    }
 }
 
 // Returns true if [obj] posesses an item with 0x2000 flag.
@@ -1428,6 +1602,9 @@ void ammoSetQuantity(Object* ammoOrWeapon, int quantity)
         quantity = 0;
     }
 
+    // CE: Ammo weight is a part of inventory weight.
+    itemInvalidateInventory(ammoOrWeapon->owner);
+
     Proto* proto;
     protoGetProto(ammoOrWeapon->pid, &proto);
 
@@ -3164,6 +3341,14 @@ int itemGetTotalCaps(Object* obj)
     int amount = 0;
 
     Inventory* inventory = &(obj->data.inventory);
+
+    // CE: Use cached amount, nested containers are counted from their own
+    // caches.
+    InventoryCache* cache = &(gInventoryCaches[inventory]);
+    if ((cache->flags & INVENTORY_CACHE_CAPS) != 0) {
+        return cache->caps;
+    }
+
     for (int i = 0; i < inventory->length; i++) {
         InventoryItem* inventoryItem = &(inventory->items[i]);
         Object* item = inventoryItem->item;
@@ -3178,6 +3363,9 @@ int itemGetTotalCaps(Object* obj)
         }
     }
 
+    cache->caps = amount;
+    cache->flags |= INVENTORY_CACHE_CAPS;
+
     return amount;
 }
 
@@ -3238,6 +3426,8 @@ int itemCapsAdjust(Object* obj, int amount)
             }
         }
 
+        itemInvalidateInventory(obj);
+
         return 0;
     }
 
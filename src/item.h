@@ -50,6 +50,10 @@ int itemGetInventoryFid(Object* obj);
 Object* critterGetWeaponForHitMode(Object* critter, int hitMode);
 int itemGetActionPointCost(Object* obj, int hitMode, bool aiming);
 int itemGetQuantity(Object* obj, Object* item);
+Object* itemFindByPid(Object* obj, int pid, int* quantityPtr);
+Object* itemFindById(Object* obj, int id);
+void itemInvalidateInventory(Object* owner);
+void itemFreeInventoryCache(Inventory* inventory);
 int itemIsQueued(Object* obj);
 Object* itemReplace(Object* owner, Object* itemToReplace, int flags);
 bool itemIsHidden(Object* obj);
@@ -12,6 +12,8 @@ namespace fallout {
 // 20% of max light per "Night Vision" rank
 #define LIGHT_LEVEL_NIGHT_VISION_BONUS (65536 / 5)
 
+static void lightTileIntensityChanged(int elevation, int tile, int oldIntensity);
+
 // 0x51923C
 static int gAmbientIntensity = LIGHT_INTENSITY_MAX;
 
@@ -53,6 +55,13 @@ void lightSetAmbientIntensity(int intensity, bool shouldUpdateScreen)
     int oldAmbientIntensity = gAmbientIntensity;
     gAmbientIntensity = normalizedIntensity;
 
+    // CE: Floors are cached with lighting applied. Dropping them here keeps
+    // every cached floor lit with current ambient light, which is assumed by
+    // |lightTileIntensityChanged|.
+    if (oldAmbientIntensity != normalizedIntensity) {
+        tileInvalidateFloorCache();
+    }
+
     if (shouldUpdateScreen) {
         if (oldAmbientIntensity != normalizedIntensity) {
             tileWindowRefresh();
@@ -99,7 +108,11 @@ void lightSetTileIntensity(int elevation, int tile, int intensity)
         return;
     }
 
+    int oldIntensity = gTileIntensity[elevation][tile];
     gTileIntensity[elevation][tile] = intensity;
+
+    // CE: Floors are cached with lighting applied.
+    lightTileIntensityChanged(elevation, tile, oldIntensity);
 }
 
 // 0x47AA10
@@ -113,7 +126,11 @@ void lightIncreaseTileIntensity(int elevation, int tile, int intensity)
         return;
     }
 
+    int oldIntensity = gTileIntensity[elevation][tile];
     gTileIntensity[elevation][tile] += intensity;
+
+    // CE: Floors are cached with lighting applied.
+    lightTileIntensityChanged(elevation, tile, oldIntensity);
 }
 
 // 0x47AA48
@@ -127,7 +144,11 @@ void lightDecreaseTileIntensity(int elevation, int tile, int intensity)
         return;
     }
 
+    int oldIntensity = gTileIntensity[elevation][tile];
     gTileIntensity[elevation][tile] -= intensity;
+
+    // CE: Floors are cached with lighting applied.
+    lightTileIntensityChanged(elevation, tile, oldIntensity);
 }
 
 // 0x47AA84
@@ -138,6 +159,22 @@ void lightResetTileIntensity()
             gTileIntensity[elevation][tile] = 655;
         }
     }
+
+    // CE: Floors are cached with lighting applied.
+    tileInvalidateFloorCache();
+}
+
+// CE: Invalidates cached floors around [tile] if the change of its intensity
+// is visible. Floors are lit with clamped tile intensity, but never darker
+// than ambient light. Cached floors are always lit with current ambient light
+// (see |lightSetAmbientIntensity|).
+static void lightTileIntensityChanged(int elevation, int tile, int oldIntensity)
+{
+    int oldLight = std::max(std::min(oldIntensity, LIGHT_INTENSITY_MAX), gAmbientIntensity);
+    int newLight = std::max(std::min(gTileIntensity[elevation][tile], LIGHT_INTENSITY_MAX), gAmbientIntensity);
+    if (oldLight != newLight) {
+        tileInvalidateFloorCacheAroundTile(tile, elevation);
+    }
 }
 
 } // namespace fallout
@@ -50,6 +50,7 @@
 #include "sfall_config.h"
 #include "sfall_global_scripts.h"
 #include "sfall_global_vars.h"
+#include "sfall_ini.h"
 #include "skill.h"
 #include "stat.h"
 #include "svga.h"
@@ -158,6 +159,9 @@ static int _QuickSnapShot();
 static int lsgWindowInit(int windowType);
 static int lsgWindowFree(int windowType);
 static int lsgPerformSaveGame();
+static int lsgFinishSaveGame();
+static void lsgSaveGameTicker();
+static void lsgShowDeferredSaveResult(int rc);
 static int lsgLoadGameInSlot(int slot);
 static int lsgSaveHeaderInSlot(int slot);
 static int lsgLoadHeaderInSlot(int slot);
@@ -174,6 +178,7 @@ static int _GameMap2Slot(File* stream);
 static int _SlotMap2Game(File* stream);
 static int _mygets(char* dest, File* stream);
 static int _copy_file(const char* existingFileName, const char* newFileName);
+static int lsgCopyCompressed(const char* existingFilePath, const char* newFilePath);
 static int _SaveBackup();
 static int _RestoreSave();
 static int _LoadObjDudeCid(File* stream);
@@ -345,6 +350,14 @@ static FrmImage _loadsaveFrmImages[LOAD_SAVE_FRM_COUNT];
 static int quickSaveSlots = 0;
 static bool autoQuickSaveSlots = false;
 
+// CE: Map and proto snapshots of the last save which are still being
+// compressed and written to the slot in the background. The slot is complete
+// only when `SAVE.TMP` is renamed to `SAVE.DAT` at the end of the batch.
+static FileCopyBatch* gLoadSaveBatch = nullptr;
+static int gLoadSaveBatchSlot;
+static int gLoadSaveBatchMapBackupCount;
+static bool gLoadSaveBatchAutomapDbFlag;
+
 // 0x47B7E4
 void _InitLoadSave()
 {
@@ -381,6 +394,12 @@ int lsgSaveGame(int mode)
     _ls_error_code = 0;
     _patches = settings.system.master_patches_path.c_str();
 
+    // CE: Slot headers (and the slot itself) can only be trusted once
+    // previous save is fully written.
+    if (gLoadSaveBatch != nullptr) {
+        lsgShowDeferredSaveResult(lsgFinishSaveGame());
+    }
+
     // SFALL: skip slot selection if auto quicksave is enabled
     if (autoQuickSaveSlots) {
         _quick_done = true;
@@ -1011,6 +1030,11 @@ int lsgLoadGame(int mode)
     _ls_error_code = 0;
     _patches = settings.system.master_patches_path.c_str();
 
+    // CE: Make sure the slot we're about to load is complete.
+    if (gLoadSaveBatch != nullptr) {
+        lsgShowDeferredSaveResult(lsgFinishSaveGame());
+    }
+
     if (mode == LOAD_SAVE_MODE_QUICK && _quick_done) {
         int quickSaveWindowX = (screenGetWidth() - LS_WINDOW_WIDTH) / 2;
         int quickSaveWindowY = (screenGetHeight() - LS_WINDOW_HEIGHT) / 2;
@@ -1761,6 +1785,10 @@ static int lsgPerformSaveGame()
 
     backgroundSoundPause();
 
+    // CE: Make sure settings written by scripts are not lost if the game
+    // crashes after saving.
+    sfall_ini_flush();
+
     snprintf(_gmpath, sizeof(_gmpath), "%s\\%s", _patches, "SAVEGAME");
     compat_mkdir(_gmpath);
 
@@ -1782,14 +1810,20 @@ static int lsgPerformSaveGame()
         debugPrint("\nLOADSAVE: Warning, can't backup save file!\n");
     }
 
+    gLoadSaveBatch = fileCopyBatchCreate();
+
+    // CE: Save data is written to temporary file which is renamed to
+    // `SAVE.DAT` once background writes are done.
     snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
-    strcat(_gmpath, "SAVE.DAT");
+    strcat(_gmpath, "SAVE.TMP");
 
     debugPrint("\nLOADSAVE: Save name: %s\n", _gmpath);
 
     _flptr = fileOpen(_gmpath, "wb");
     if (_flptr == nullptr) {
         debugPrint("\nLOADSAVE: ** Error opening save game for writing! **\n");
+        fileCopyBatchWait(gLoadSaveBatch);
+        gLoadSaveBatch = nullptr;
         _RestoreSave();
         snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
         MapDirErase(_gmpath, "BAK");
@@ -1803,6 +1837,8 @@ static int lsgPerformSaveGame()
         debugPrint("\nLOADSAVE: ** Error writing save game header! **\n");
         debugPrint("LOADSAVE: Save file header size written: %d bytes.\n", fileTell(_flptr) - pos);
         fileClose(_flptr);
+        fileCopyBatchWait(gLoadSaveBatch);
+        gLoadSaveBatch = nullptr;
         _RestoreSave();
         snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
         MapDirErase(_gmpath, "BAK");
@@ -1817,6 +1853,8 @@ static int lsgPerformSaveGame()
         if (handler(_flptr) == -1) {
             debugPrint("\nLOADSAVE: ** Error writing save function #%d data! **\n", index);
             fileClose(_flptr);
+            fileCopyBatchWait(gLoadSaveBatch);
+            gLoadSaveBatch = nullptr;
             _RestoreSave();
             snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
             MapDirErase(_gmpath, "BAK");
@@ -1899,12 +1937,22 @@ static int lsgPerformSaveGame()
         fileClose(_flptr);
     }
 
-    snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
-    MapDirErase(_gmpath, "BAK");
+    snprintf(_str0, sizeof(_str0), "%s\\%s\\%s%.2d\\%s", _patches, "SAVEGAME", "SLOT", _slot_cursor + 1, "SAVE.TMP");
+    snprintf(_str1, sizeof(_str1), "%s\\%s\\%s%.2d\\%s", _patches, "SAVEGAME", "SLOT", _slot_cursor + 1, "SAVE.DAT");
+    fileCopyBatchAddRename(gLoadSaveBatch, _str0, _str1);
+
+    gLoadSaveBatchSlot = _slot_cursor;
+    gLoadSaveBatchMapBackupCount = _map_backup_count;
+    gLoadSaveBatchAutomapDbFlag = _automap_db_flag;
+    fileCopyBatchStart(gLoadSaveBatch);
 
 #if defined(__EMSCRIPTEN__)
-    do_save_idbfs_loadsave();
-#endif
+    // Batch is run synchronously, finish right away so that storage is
+    // synced.
+    if (lsgFinishSaveGame() == -1) {
+        backgroundSoundResume();
+        return -1;
+    }
 
     gLoadSaveMessageListItem.num = 140;
     if (messageListGetItem(&gLoadSaveMessageList, &gLoadSaveMessageListItem)) {
@@ -1912,12 +1960,146 @@ static int lsgPerformSaveGame()
     } else {
         debugPrint("\nError: Couldn't find LoadSave Message!");
     }
+#else
+    // CE: The game is reported as saved once background writes are done,
+    // see |lsgHandlePendingSave|.
+    displayMonitorSetProgress(0);
+    tickersAdd(lsgSaveGameTicker);
+#endif
 
     backgroundSoundResume();
 
     return 0;
 }
 
+// CE: Waits for background part of the last save and either commits or rolls
+// back the slot.
+static int lsgFinishSaveGame()
+{
+    if (gLoadSaveBatch == nullptr) {
+        return 0;
+    }
+
+    tickersRemove(lsgSaveGameTicker);
+    displayMonitorSetProgress(-1);
+
+    int rc = fileCopyBatchWait(gLoadSaveBatch);
+    gLoadSaveBatch = nullptr;
+
+    // Backup helpers operate on current slot.
+    int slot = _slot_cursor;
+    int mapBackupCount = _map_backup_count;
+    bool automapDbFlag = _automap_db_flag;
+    _slot_cursor = gLoadSaveBatchSlot;
+    _map_backup_count = gLoadSaveBatchMapBackupCount;
+    _automap_db_flag = gLoadSaveBatchAutomapDbFlag;
+
+    if (rc == -1) {
+        debugPrint("\nLOADSAVE: ** Error writing save game files! **\n");
+        _RestoreSave();
+    }
+
+    snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
+    MapDirErase(_gmpath, "BAK");
+
+    _slot_cursor = slot;
+    _map_backup_count = mapBackupCount;
+    _automap_db_flag = automapDbFlag;
+
+#if defined(__EMSCRIPTEN__)
+    do_save_idbfs_loadsave();
+#endif
+
+    return rc;
+}
+
+// CE: Shows progress of background part of the last save. Finishing the
+// save involves slot rollback and possibly a modal dialog, so it's left to
+// |lsgHandlePendingSave|.
+static void lsgSaveGameTicker()
+{
+    if (gLoadSaveBatch == nullptr) {
+        return;
+    }
+
+    if (!fileCopyBatchIsDone(gLoadSaveBatch)) {
+        displayMonitorSetProgress(fileCopyBatchGetProgress(gLoadSaveBatch));
+        return;
+    }
+
+    displayMonitorSetProgress(-1);
+    tickersRemove(lsgSaveGameTicker);
+}
+
+// CE: Finishes background part of the last save once it's done and reports
+// the result. Called from the main loop, so that it only happens on the map
+// without any other screen or dialog open.
+void lsgHandlePendingSave()
+{
+    if (gLoadSaveBatch == nullptr) {
+        return;
+    }
+
+    if (!fileCopyBatchIsDone(gLoadSaveBatch)) {
+        return;
+    }
+
+    if (GameMode::getCurrentGameMode() != 0) {
+        return;
+    }
+
+    lsgShowDeferredSaveResult(lsgFinishSaveGame());
+}
+
+// CE: Reports result of background part of the save which has been finished
+// outside of save screen.
+static void lsgShowDeferredSaveResult(int rc)
+{
+    MessageList messageList;
+    MessageListItem messageListItem;
+
+    if (!messageListInit(&messageList)) {
+        return;
+    }
+
+    char path[COMPAT_MAX_PATH];
+    snprintf(path, sizeof(path), "%s%s", asc_5186C8, "LSGAME.MSG");
+    if (messageListLoad(&messageList, path)) {
+        if (rc == -1) {
+            soundPlayFile("iisxxxx1");
+
+            // Error saving game!
+            strcpy(_str0, getmsg(&messageList, &messageListItem, 132));
+            // Unable to save game.
+            strcpy(_str1, getmsg(&messageList, &messageListItem, 133));
+
+            const char* body[] = {
+                _str1,
+            };
+            showDialogBox(_str0, body, 1, 169, 116, _colorTable[32328], nullptr, _colorTable[32328], DIALOG_BOX_LARGE);
+        } else {
+            // Game saved.
+            messageListItem.num = 140;
+            if (messageListGetItem(&messageList, &messageListItem)) {
+                displayMonitorAddMessage(messageListItem.text);
+            }
+        }
+    }
+
+    messageListFree(&messageList);
+}
+
+// CE: Waits for pending background save and reports if it failed, since
+// the game was not yet reported as saved.
+void lsgExit()
+{
+    if (gLoadSaveBatch != nullptr) {
+        if (lsgFinishSaveGame() == -1) {
+            lsgShowDeferredSaveResult(-1);
+        }
+    }
+}
+
 // 0x47DC60
 bool _isLoadingGame()
 {
@@ -2756,7 +2938,7 @@ static int _GameMap2Slot(File* stream)
             : PROTO_DIR_NAME "\\" ITEMS_DIR_NAME;
         snprintf(_str0, sizeof(_str0), "%s\\%s\\%s", _patches, critterItemPath, path);
         snprintf(_str1, sizeof(_str1), "%s\\%s\\%s%.2d\\%s\\%s", _patches, "SAVEGAME", "SLOT", _slot_cursor + 1, critterItemPath, path);
-        if (fileCopyCompressed(_str0, _str1) == -1) {
+        if (lsgCopyCompressed(_str0, _str1) == -1) {
             return -1;
         }
     }
@@ -2800,7 +2982,7 @@ static int _GameMap2Slot(File* stream)
 
         snprintf(_str0, sizeof(_str0), "%s\\%s\\%s", _patches, "MAPS", string);
         snprintf(_str1, sizeof(_str1), "%s\\%s\\%s%.2d\\%s", _patches, "SAVEGAME", "SLOT", _slot_cursor + 1, string);
-        if (fileCopyCompressed(_str0, _str1) == -1) {
+        if (lsgCopyCompressed(_str0, _str1) == -1) {
             fileNameListFree(&fileNameList, 0);
             return -1;
         }
@@ -2812,7 +2994,7 @@ static int _GameMap2Slot(File* stream)
     snprintf(_str1, sizeof(_str1), "%s\\%s\\%s%.2d\\%s", _patches, "SAVEGAME", "SLOT", _slot_cursor + 1, _str0);
     snprintf(_str0, sizeof(_str0), "%s\\%s\\%s", _patches, "MAPS", "AUTOMAP.DB");
 
-    if (fileCopyCompressed(_str0, _str1) == -1) {
+    if (lsgCopyCompressed(_str0, _str1) == -1) {
         return -1;
     }
 
@@ -2922,6 +3104,8 @@ static int _SlotMap2Game(File* stream)
         return -1;
     }
 
+    automapInvalidateCache();
+
     snprintf(_str1, sizeof(_str1), "%s\\%s", "MAPS", "AUTOMAP.DB");
 
     int v12;
@@ -3037,6 +3221,17 @@ out:
     return result;
 }
 
+// CE: Snapshots file into pending save batch (if any), otherwise copies it
+// immediately.
+static int lsgCopyCompressed(const char* existingFilePath, const char* newFilePath)
+{
+    if (gLoadSaveBatch != nullptr) {
+        return fileCopyBatchAddCompressed(gLoadSaveBatch, existingFilePath, newFilePath);
+    }
+
+    return fileCopyCompressed(existingFilePath, newFilePath);
+}
+
 // InitLoadSave
 // 0x48000C
 void lsgInit()
@@ -3247,6 +3442,11 @@ static int _EraseSave()
     strcat(_str0, "SAVE.DAT");
     compat_remove(_str0);
 
+    // CE: Remove incomplete background save.
+    strcpy(_str0, _gmpath);
+    strcat(_str0, "SAVE.TMP");
+    compat_remove(_str0);
+
     snprintf(_gmpath, sizeof(_gmpath), "%s\\%s%.2d\\", "SAVEGAME", "SLOT", _slot_cursor + 1);
     snprintf(_str0, sizeof(_str0), "%s*.%s", _gmpath, "SAV");
 
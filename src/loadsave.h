@@ -20,6 +20,8 @@ int lsgSaveGame(int mode);
 int lsgLoadGame(int mode);
 bool _isLoadingGame();
 void lsgInit();
+void lsgExit();
+void lsgHandlePendingSave();
 int MapDirErase(const char* path, const char* extension);
 int _MapDirEraseFile_(const char* a1, const char* a2);
 
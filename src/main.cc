@@ -345,6 +345,9 @@ static void mainLoop()
 
         mapHandleTransition();
 
+        // CE: Report background save once it's done.
+        lsgHandlePendingSave();
+
         if (_main_game_paused != 0) {
             _main_game_paused = 0;
         }
@@ -2,10 +2,15 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <vector>
 
+#if !defined(__EMSCRIPTEN__)
+#include <thread>
+#endif
+
 #include "animation.h"
 #include "art.h"
 #include "automap.h"
@@ -71,6 +76,8 @@ static void _square_reset();
 static int _square_load(File* stream, int a2);
 static int mapHeaderWrite(MapHeader* ptr, File* stream);
 static int mapHeaderRead(MapHeader* ptr, File* stream);
+static File* mapPreloadTake(const char* filePath);
+static void mapPreloadProc();
 
 // 0x50B058
 static char byte_50B058[] = "";
@@ -174,6 +181,19 @@ static std::vector<void*> gMapGlobalPointers;
 // to store these pointers.
 static std::vector<void*> gMapLocalPointers;
 
+// CE: Speculative preload of the map the player is likely heading to. The
+// map file is opened on the main thread (opening touches shared .DAT state),
+// and then read and decompressed in the background into a memory block which
+// `mapLoadByName` parses instead of the file.
+#if !defined(__EMSCRIPTEN__)
+static std::thread gMapPreloadThread;
+#endif
+static File* gMapPreloadStream = nullptr;
+static int gMapPreloadMap = -1;
+static char gMapPreloadPath[COMPAT_MAX_PATH];
+static unsigned char* gMapPreloadData = nullptr;
+static long gMapPreloadSize;
+
 // iso_init
 // 0x481CA0
 int isoInit()
@@ -249,6 +269,8 @@ int isoInit()
 // 0x481ED4
 void isoReset()
 {
+    mapPreloadCancel();
+
     // NOTE: Uninline.
     mapGlobalVariablesFree();
 
@@ -268,6 +290,8 @@ void isoReset()
 // 0x481F48
 void isoExit()
 {
+    mapPreloadCancel();
+
     interfaceFree();
     colorCycleFree();
     objectsExit();
@@ -784,7 +808,10 @@ int mapLoadByName(char* fileName)
 
     if (rc == -1) {
         const char* filePath = mapBuildPath(fileName);
-        File* stream = fileOpen(filePath, "rb");
+        File* stream = mapPreloadTake(filePath);
+        if (stream == nullptr) {
+            stream = fileOpen(filePath, "rb");
+        }
         if (stream != nullptr) {
             rc = mapLoad(stream);
             fileClose(stream);
@@ -796,9 +823,150 @@ int mapLoadByName(char* fileName)
         }
     }
 
+    // CE: Preload (if any) was for some other map.
+    mapPreloadCancel();
+
     return rc;
 }
 
+// CE: Starts reading [map] in the background so that upcoming transition to
+// it does not have to wait for disk and decompression.
+void mapPreload(int map)
+{
+#if !defined(__EMSCRIPTEN__)
+    // Current map is saved when leaving it, so its file is about to change.
+    if (map <= 0 || map == gMapHeader.index || map == gMapPreloadMap) {
+        return;
+    }
+
+    mapPreloadCancel();
+
+    char name[16];
+    if (wmMapIdxToName(map, name, sizeof(name)) == -1) {
+        return;
+    }
+
+    compat_strupr(name);
+
+    char* extension = strstr(name, ".MAP");
+    if (extension == nullptr) {
+        return;
+    }
+
+    // Saved map takes precedence, see `mapLoadByName`.
+    strcpy(extension, ".SAV");
+
+    File* stream = fileOpen(mapBuildPath(name), "rb");
+    if (stream == nullptr) {
+        strcpy(extension, ".MAP");
+        stream = fileOpen(mapBuildPath(name), "rb");
+        if (stream == nullptr) {
+            return;
+        }
+    }
+
+    strcpy(gMapPreloadPath, mapBuildPath(name));
+    gMapPreloadStream = stream;
+    gMapPreloadMap = map;
+    gMapPreloadData = nullptr;
+    gMapPreloadSize = 0;
+    gMapPreloadThread = std::thread(mapPreloadProc);
+#endif
+}
+
+void mapPreloadCancel()
+{
+    if (gMapPreloadStream == nullptr) {
+        return;
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    gMapPreloadThread.join();
+#endif
+
+    fileClose(gMapPreloadStream);
+    gMapPreloadStream = nullptr;
+    gMapPreloadMap = -1;
+
+    if (gMapPreloadData != nullptr) {
+        free(gMapPreloadData);
+        gMapPreloadData = nullptr;
+    }
+}
+
+// Returns memory stream with preloaded contents of [filePath], or `nullptr`
+// if it was not preloaded.
+static File* mapPreloadTake(const char* filePath)
+{
+    if (gMapPreloadStream == nullptr || compat_stricmp(gMapPreloadPath, filePath) != 0) {
+        return nullptr;
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    gMapPreloadThread.join();
+#endif
+
+    fileClose(gMapPreloadStream);
+    gMapPreloadStream = nullptr;
+    gMapPreloadMap = -1;
+
+    if (gMapPreloadData == nullptr) {
+        return nullptr;
+    }
+
+    File* stream = fileOpenMemory(gMapPreloadData, gMapPreloadSize);
+    if (stream == nullptr) {
+        free(gMapPreloadData);
+    }
+
+    gMapPreloadData = nullptr;
+
+    return stream;
+}
+
+// Runs on preload thread. Only touches preload stream, which is not used
+// anywhere else until the thread is joined.
+static void mapPreloadProc()
+{
+    unsigned char* data = nullptr;
+    size_t capacity = 0;
+    size_t size = 0;
+
+    for (;;) {
+        if (size == capacity) {
+            // NOTE: Gzipped streams (saved maps) do not report their size, so
+            // the buffer is grown as needed.
+            capacity = capacity != 0 ? capacity * 2 : 0x10000;
+
+            unsigned char* newData = (unsigned char*)realloc(data, capacity);
+            if (newData == nullptr) {
+                free(data);
+                return;
+            }
+
+            data = newData;
+        }
+
+        // NOTE: Use `xfileRead` directly, `fileRead` reports progress which
+        // is not thread-safe.
+        size_t bytesRead = xfileRead(data + size, 1, capacity - size, gMapPreloadStream);
+        if (bytesRead == 0) {
+            break;
+        }
+
+        if (bytesRead > capacity - size) {
+            // Read error.
+            free(data);
+            return;
+        }
+
+        size += bytesRead;
+    }
+
+    gMapPreloadData = data;
+    gMapPreloadSize = static_cast<long>(size);
+}
+
 // 0x482B34
 int mapLoadById(int map)
 {
@@ -1703,6 +1871,9 @@ static void square_init()
 // 0x484210
 static void _square_reset()
 {
+    // CE: Squares are about to change.
+    tileInvalidateFloorCache();
+
     for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
         int* p = _square[elevation]->field_0;
         for (int y = 0; y < SQUARE_GRID_HEIGHT; y++) {
@@ -1759,6 +1930,9 @@ static int _square_load(File* stream, int flags)
         }
     }
 
+    // CE: Drop anything rendered while squares were being read.
+    tileInvalidateFloorCache();
+
     return 0;
 }
 
@@ -106,6 +106,8 @@ void mapNewMap();
 int mapLoadByName(char* fileName);
 int mapLoadById(int map_index);
 int mapLoadSaved(char* fileName);
+void mapPreload(int map);
+void mapPreloadCancel();
 int _map_target_load_area();
 int mapSetTransition(MapTransition* transition);
 int mapHandleTransition();
@@ -14,6 +14,20 @@ namespace fallout {
 // A special value that denotes an ending of a memory block data.
 #define MEMORY_BLOCK_FOOTER_GUARD (0xBEEFCAFE)
 
+// CE: Alignment of pool blocks and frame allocations.
+#define MEMORY_ALIGNMENT (16)
+
+// CE: Initial size of the frame arena.
+#define MEMORY_FRAME_ARENA_INITIAL_SIZE (64 * 1024)
+
+// CE: Frame arena never grows beyond this size, larger frames are served with
+// overflow blocks.
+#define MEMORY_FRAME_ARENA_MAX_SIZE (4 * 1024 * 1024)
+
+// CE: Max total size of overflow blocks between resets, allocations beyond it
+// fail.
+#define MEMORY_FRAME_OVERFLOW_MAX_SIZE (4 * 1024 * 1024)
+
 // A header of a memory block.
 typedef struct MemoryBlockHeader {
     // Size of the memory block including header and footer.
@@ -29,11 +43,40 @@ typedef struct MemoryBlockFooter {
     int guard;
 } MemoryBlockFooter;
 
+// CE: Header of a memory pool chunk, followed by blocks.
+typedef struct MemoryPoolChunk {
+    struct MemoryPoolChunk* next;
+    // Keeps blocks aligned.
+    unsigned char padding[MEMORY_ALIGNMENT - sizeof(void*)];
+} MemoryPoolChunk;
+
+// CE: Frame allocation which did not fit into frame arena.
+typedef struct MemoryFrameOverflow {
+    struct MemoryFrameOverflow* next;
+    unsigned char padding[MEMORY_ALIGNMENT - sizeof(void*)];
+} MemoryFrameOverflow;
+
+typedef struct MemoryFrameArena {
+    unsigned char* data;
+    size_t capacity;
+    size_t used;
+    // Total size requested in current frame, including overflow blocks.
+    size_t requested;
+    size_t peak;
+    MemoryFrameOverflow* overflow;
+    size_t overflowSize;
+    unsigned int frames;
+    unsigned int overflows;
+} MemoryFrameArena;
+
 static void* memoryBlockMallocImpl(size_t size);
 static void* memoryBlockReallocImpl(void* ptr, size_t size);
 static void memoryBlockFreeImpl(void* ptr);
 static void* mem_prep_block(void* block, size_t size);
 static void memoryBlockValidate(void* block);
+static size_t memoryAlign(size_t size);
+static void memoryPoolsPrintStats();
+static void memoryFramePrintStats();
 
 // 0x51DED0
 static MallocProc* gMallocProc = memoryBlockMallocImpl;
@@ -56,6 +99,11 @@ static size_t gMemoryBlocksCurrentSize = 0;
 // 0x51DEE8
 static size_t gMemoryBlocksMaximumSize = 0;
 
+// CE: List of pools which allocated at least one chunk.
+static MemoryPool* gMemoryPools = nullptr;
+
+static MemoryFrameArena gMemoryFrameArena;
+
 // 0x4C5A80
 char* internal_strdup(const char* string)
 {
@@ -182,6 +230,9 @@ void mem_check()
         debugPrint("Current memory allocated: %6d blocks, %9u bytes total\n", gMemoryBlocksCurrentCount, gMemoryBlocksCurrentSize);
         debugPrint("Max memory allocated:     %6d blocks, %9u bytes total\n", gMemoryBlockMaximumCount, gMemoryBlocksMaximumSize);
     }
+
+    memoryPoolsPrintStats();
+    memoryFramePrintStats();
 }
 
 // NOTE: Inlined.
@@ -220,4 +271,200 @@ static void memoryBlockValidate(void* block)
     }
 }
 
+static size_t memoryAlign(size_t size)
+{
+    return (size + MEMORY_ALIGNMENT - 1) & ~static_cast<size_t>(MEMORY_ALIGNMENT - 1);
+}
+
+void* memoryPoolAlloc(MemoryPool* pool)
+{
+    if (pool->freeList == nullptr) {
+        size_t blockSize = memoryAlign(pool->blockSize);
+        MemoryPoolChunk* chunk = (MemoryPoolChunk*)malloc(sizeof(*chunk) + blockSize * pool->blocksPerChunk);
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+
+        if (pool->chunks == nullptr) {
+            pool->next = gMemoryPools;
+            gMemoryPools = pool;
+        }
+
+        chunk->next = (MemoryPoolChunk*)pool->chunks;
+        pool->chunks = chunk;
+        pool->chunksLength++;
+
+        // Thread blocks in reverse so they are handed out in address order.
+        unsigned char* blocks = (unsigned char*)chunk + sizeof(*chunk);
+        for (int index = pool->blocksPerChunk - 1; index >= 0; index--) {
+            void** block = (void**)(blocks + blockSize * index);
+            *block = pool->freeList;
+            pool->freeList = block;
+        }
+    }
+
+    void** block = (void**)pool->freeList;
+    pool->freeList = *block;
+
+    pool->blocksUsed++;
+    if (pool->blocksUsed > pool->blocksPeak) {
+        pool->blocksPeak = pool->blocksUsed;
+    }
+    pool->allocations++;
+
+    return block;
+}
+
+void memoryPoolFree(MemoryPool* pool, void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    *(void**)ptr = pool->freeList;
+    pool->freeList = ptr;
+    pool->blocksUsed--;
+}
+
+// Releases all chunks of the pool. Chunks are kept if some blocks are still in
+// use, since they might be referenced.
+void memoryPoolExit(MemoryPool* pool)
+{
+    if (pool->blocksUsed != 0) {
+        debugPrint("Memory pool %s: %d blocks still in use on exit\n", pool->name, pool->blocksUsed);
+        return;
+    }
+
+    MemoryPoolChunk* chunk = (MemoryPoolChunk*)pool->chunks;
+    while (chunk != nullptr) {
+        MemoryPoolChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    if (pool->chunks != nullptr) {
+        MemoryPool** poolPtr = &gMemoryPools;
+        while (*poolPtr != nullptr) {
+            if (*poolPtr == pool) {
+                *poolPtr = pool->next;
+                break;
+            }
+            poolPtr = &((*poolPtr)->next);
+        }
+    }
+
+    pool->freeList = nullptr;
+    pool->chunks = nullptr;
+    pool->chunksLength = 0;
+    pool->next = nullptr;
+}
+
+static void memoryPoolsPrintStats()
+{
+    for (MemoryPool* pool = gMemoryPools; pool != nullptr; pool = pool->next) {
+        debugPrint("Memory pool %-16s: %6d blocks used, %6d peak, %4d chunks, %9u allocations\n",
+            pool->name,
+            pool->blocksUsed,
+            pool->blocksPeak,
+            pool->chunksLength,
+            pool->allocations);
+    }
+}
+
+void* memoryFrameAlloc(size_t size)
+{
+    MemoryFrameArena* arena = &gMemoryFrameArena;
+
+    size = memoryAlign(size);
+    arena->requested += size;
+
+    if (arena->data == nullptr) {
+        arena->data = (unsigned char*)malloc(MEMORY_FRAME_ARENA_INITIAL_SIZE);
+        if (arena->data != nullptr) {
+            arena->capacity = MEMORY_FRAME_ARENA_INITIAL_SIZE;
+        }
+    }
+
+    if (arena->capacity - arena->used >= size) {
+        void* ptr = arena->data + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    // Does not fit, keep it until the end of the frame. The arena is grown on
+    // reset to fit such frames next time.
+    if (arena->overflowSize + size > MEMORY_FRAME_OVERFLOW_MAX_SIZE) {
+        return nullptr;
+    }
+
+    MemoryFrameOverflow* overflow = (MemoryFrameOverflow*)malloc(sizeof(*overflow) + size);
+    if (overflow == nullptr) {
+        return nullptr;
+    }
+
+    overflow->next = arena->overflow;
+    arena->overflow = overflow;
+    arena->overflowSize += size;
+    arena->overflows++;
+
+    return (unsigned char*)overflow + sizeof(*overflow);
+}
+
+void memoryFrameReset()
+{
+    MemoryFrameArena* arena = &gMemoryFrameArena;
+
+    if (arena->requested > arena->peak) {
+        arena->peak = arena->requested;
+    }
+
+    if (arena->overflow != nullptr) {
+        while (arena->overflow != nullptr) {
+            MemoryFrameOverflow* next = arena->overflow->next;
+            free(arena->overflow);
+            arena->overflow = next;
+        }
+
+        if (arena->capacity < MEMORY_FRAME_ARENA_MAX_SIZE) {
+            size_t capacity = arena->capacity != 0 ? arena->capacity : MEMORY_FRAME_ARENA_INITIAL_SIZE;
+            while (capacity < arena->requested && capacity < MEMORY_FRAME_ARENA_MAX_SIZE) {
+                capacity *= 2;
+            }
+
+            unsigned char* data = (unsigned char*)malloc(capacity);
+            if (data != nullptr) {
+                free(arena->data);
+                arena->data = data;
+                arena->capacity = capacity;
+            }
+        }
+    }
+
+    arena->used = 0;
+    arena->requested = 0;
+    arena->overflowSize = 0;
+    arena->frames++;
+}
+
+void memoryFrameExit()
+{
+    MemoryFrameArena* arena = &gMemoryFrameArena;
+
+    memoryFrameReset();
+
+    free(arena->data);
+    arena->data = nullptr;
+    arena->capacity = 0;
+}
+
+static void memoryFramePrintStats()
+{
+    MemoryFrameArena* arena = &gMemoryFrameArena;
+    debugPrint("Frame arena: %9u bytes capacity, %9u bytes peak, %6u overflows in %u frames\n",
+        static_cast<unsigned int>(arena->capacity),
+        static_cast<unsigned int>(arena->peak),
+        arena->overflows,
+        arena->frames);
+}
+
 } // namespace fallout
@@ -11,6 +11,44 @@ void* internal_realloc(void* ptr, size_t size);
 void internal_free(void* ptr);
 void mem_check();
 
+// CE: Pool of fixed size blocks for hot small structs. Blocks are carved from
+// chunks allocated in bulk and recycled through a free list, bypassing block
+// headers and validation of |internal_malloc|.
+//
+// Pools are meant to be defined statically with |MEMORY_POOL_INITIALIZER|,
+// they are registered for stats reporting on first allocation.
+typedef struct MemoryPool {
+    const char* name;
+    size_t blockSize;
+    int blocksPerChunk;
+    void* freeList;
+    void* chunks;
+    int chunksLength;
+    int blocksUsed;
+    int blocksPeak;
+    unsigned int allocations;
+    struct MemoryPool* next;
+} MemoryPool;
+
+#define MEMORY_POOL_INITIALIZER(name, type, blocksPerChunk) \
+    { name, sizeof(type), blocksPerChunk, nullptr, nullptr, 0, 0, 0, 0, nullptr }
+
+void* memoryPoolAlloc(MemoryPool* pool);
+void memoryPoolFree(MemoryPool* pool, void* ptr);
+void memoryPoolExit(MemoryPool* pool);
+
+// CE: Scratch memory valid until the next |_process_bk| call. Allocations are
+// bumped from a single buffer, which is reset at the start of |_process_bk|,
+// so callers never free them. Note that |_process_bk| is also called from
+// nested loops (combat, dialogs, scripts), so allocations must not be kept
+// across anything that processes input.
+//
+// Returns |nullptr| when the budget of current tick is exhausted, callers are
+// expected to fall back to |internal_malloc|.
+void* memoryFrameAlloc(size_t size);
+void memoryFrameReset();
+void memoryFrameExit();
+
 } // namespace fallout
 
 #endif /* MEMORY_H */
@@ -5,8 +5,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <array>
 #include <unordered_map>
+#include <vector>
 
 #include "debug.h"
 #include "memory.h"
@@ -20,6 +22,10 @@ namespace fallout {
 
 #define BADWORD_LENGTH_MAX 80
 
+// CE: Dense index is built when number of slots does not exceed number of
+// entries by more than this factor.
+#define MESSAGE_LIST_INDEX_SPARSENESS 4
+
 static constexpr int kFirstStandardMessageListId = 0;
 static constexpr int kLastStandardMessageListId = kFirstStandardMessageListId + STANDARD_MESSAGE_LIST_COUNT - 1;
 
@@ -40,10 +46,16 @@ struct MessageListRepositoryState {
     int nextTemporaryMessageListId = kFirstTemporaryMessageListId;
 };
 
+// CE: Header of a buffer with message file contents.
+typedef struct MessageListBuffer {
+    struct MessageListBuffer* next;
+} MessageListBuffer;
+
 static bool _message_find(MessageList* msg, int num, int* out_index);
-static bool _message_add(MessageList* msg, MessageListItem* new_entry);
+static bool _message_merge(MessageList* msg, std::vector<MessageListItem>& items);
+static void messageListBuildIndex(MessageList* msg);
 static bool _message_parse_number(int* out_num, const char* str);
-static int _message_load_field(File* file, char* str);
+static int _message_load_field(char** posPtr, char* end, char** fieldPtr);
 
 static MessageList* messageListRepositoryLoad(const char* path);
 
@@ -164,6 +176,10 @@ bool messageListInit(MessageList* messageList)
     if (messageList != nullptr) {
         messageList->entries_num = 0;
         messageList->entries = nullptr;
+        messageList->buffers = nullptr;
+        messageList->index = nullptr;
+        messageList->indexBase = 0;
+        messageList->indexLength = 0;
     }
     return true;
 }
@@ -171,24 +187,18 @@ bool messageListInit(MessageList* messageList)
 // 0x484964
 bool messageListFree(MessageList* messageList)
 {
-    int i;
-    MessageListItem* entry;
-
     if (messageList == nullptr) {
         return false;
     }
 
-    for (i = 0; i < messageList->entries_num; i++) {
-        entry = &(messageList->entries[i]);
-
-        if (entry->audio != nullptr) {
-            internal_free(entry->audio);
-        }
-
-        if (entry->text != nullptr) {
-            internal_free(entry->text);
-        }
+    // CE: Texts are stored in file buffers.
+    MessageListBuffer* buffer = (MessageListBuffer*)messageList->buffers;
+    while (buffer != nullptr) {
+        MessageListBuffer* next = buffer->next;
+        internal_free(buffer);
+        buffer = next;
     }
+    messageList->buffers = nullptr;
 
     messageList->entries_num = 0;
 
@@ -197,18 +207,29 @@ bool messageListFree(MessageList* messageList)
         messageList->entries = nullptr;
     }
 
+    if (messageList->index != nullptr) {
+        internal_free(messageList->index);
+        messageList->index = nullptr;
+    }
+    messageList->indexBase = 0;
+    messageList->indexLength = 0;
+
     return true;
 }
 
+// CE: File is read into a single buffer and tokenized in place, texts of
+// entries point into this buffer. Entries are sorted once when the file is
+// parsed instead of being inserted one by one.
+//
 // message_load
 // 0x484AA4
 bool messageListLoad(MessageList* messageList, const char* path)
 {
     char localized_path[COMPAT_MAX_PATH];
     File* file_ptr;
-    char num[MESSAGE_LIST_ITEM_FIELD_MAX_SIZE];
-    char audio[MESSAGE_LIST_ITEM_FIELD_MAX_SIZE];
-    char text[MESSAGE_LIST_ITEM_FIELD_MAX_SIZE];
+    char* num;
+    char* audio;
+    char* text;
     int rc;
     bool success;
     MessageListItem entry;
@@ -239,22 +260,49 @@ bool messageListLoad(MessageList* messageList, const char* path)
         return false;
     }
 
+    int fileSize = fileGetSize(file_ptr);
+    if (fileSize < 0) {
+        fileSize = 0;
+    }
+
+    MessageListBuffer* buffer = (MessageListBuffer*)internal_malloc(sizeof(*buffer) + fileSize + 1);
+    if (buffer == nullptr) {
+        fileClose(file_ptr);
+        return false;
+    }
+
+    char* data = (char*)(buffer + 1);
+
+    // NOTE: Text mode might shrink contents, so the number of bytes read is
+    // used instead of file size.
+    size_t length = fileRead(data, 1, fileSize, file_ptr);
+    data[length] = '\0';
+
+    fileClose(file_ptr);
+
+    buffer->next = (MessageListBuffer*)messageList->buffers;
+    messageList->buffers = buffer;
+
+    char* pos = data;
+    char* end = data + length;
+
+    std::vector<MessageListItem> items;
+
     entry.num = 0;
-    entry.audio = audio;
-    entry.text = text;
+    entry.flags = 0;
 
     while (1) {
-        rc = _message_load_field(file_ptr, num);
+        rc = _message_load_field(&pos, end, &num);
         if (rc != 0) {
             break;
         }
 
-        if (_message_load_field(file_ptr, audio) != 0) {
+        if (_message_load_field(&pos, end, &audio) != 0) {
             debugPrint("\nError loading audio field.\n", localized_path);
             goto err;
         }
 
-        if (_message_load_field(file_ptr, text) != 0) {
+        if (_message_load_field(&pos, end, &text) != 0) {
             debugPrint("\nError loading text field.\n", localized_path);
             goto err;
         }
@@ -264,10 +312,9 @@ bool messageListLoad(MessageList* messageList, const char* path)
             goto err;
         }
 
-        if (!_message_add(messageList, &entry)) {
-            debugPrint("\nError adding message.\n", localized_path);
-            goto err;
-        }
+        entry.audio = audio;
+        entry.text = text;
+        items.push_back(entry);
     }
 
     if (rc == 1) {
@@ -277,10 +324,15 @@ bool messageListLoad(MessageList* messageList, const char* path)
 err:
 
     if (!success) {
-        debugPrint("Error loading message file %s at offset %x.", localized_path, fileTell(file_ptr));
+        debugPrint("Error loading message file %s at offset %x.", localized_path, static_cast<int>(pos - data));
     }
 
-    fileClose(file_ptr);
+    // Entries parsed before an error are kept, the same way original code
+    // did.
+    if (!_message_merge(messageList, items)) {
+        debugPrint("\nError adding message.\n", localized_path);
+        success = false;
+    }
 
     return success;
 }
@@ -344,6 +396,15 @@ static bool _message_find(MessageList* msg, int num, int* out_index)
         return false;
     }
 
+    // CE: Use dense index when available.
+    if (msg->index != nullptr) {
+        unsigned int slot = static_cast<unsigned int>(num - msg->indexBase);
+        if (slot < static_cast<unsigned int>(msg->indexLength) && msg->index[slot] != -1) {
+            *out_index = msg->index[slot];
+            return true;
+        }
+    }
+
     r = msg->entries_num - 1;
     l = 0;
 
@@ -371,65 +432,81 @@ static bool _message_find(MessageList* msg, int num, int* out_index)
     return false;
 }
 
-// 0x484D68
-static bool _message_add(MessageList* msg, MessageListItem* new_entry)
+// CE: Adds parsed [items] to message list keeping entries sorted. Later items
+// replace earlier ones (including previously loaded) with the same number.
+// Replaces `_message_add`.
+static bool _message_merge(MessageList* msg, std::vector<MessageListItem>& items)
 {
-    int index;
-    MessageListItem* entries;
-    MessageListItem* existing_entry;
-
-    if (_message_find(msg, new_entry->num, &index)) {
-        existing_entry = &(msg->entries[index]);
+    if (items.empty()) {
+        return true;
+    }
 
-        if (existing_entry->audio != nullptr) {
-            internal_free(existing_entry->audio);
-        }
+    int entriesLength = msg->entries_num + static_cast<int>(items.size());
+    MessageListItem* entries = (MessageListItem*)internal_realloc(msg->entries, sizeof(*entries) * entriesLength);
+    if (entries == nullptr) {
+        return false;
+    }
 
-        if (existing_entry->text != nullptr) {
-            internal_free(existing_entry->text);
-        }
-    } else {
-        if (msg->entries != nullptr) {
-            entries = (MessageListItem*)internal_realloc(msg->entries, sizeof(MessageListItem) * (msg->entries_num + 1));
-            if (entries == nullptr) {
-                return false;
-            }
+    memcpy(entries + msg->entries_num, items.data(), sizeof(*entries) * items.size());
 
-            msg->entries = entries;
+    std::stable_sort(entries, entries + entriesLength, [](const MessageListItem& a, const MessageListItem& b) {
+        return a.num < b.num;
+    });
 
-            if (index != msg->entries_num) {
-                // Move all items below insertion point
-                memmove(&(msg->entries[index + 1]), &(msg->entries[index]), sizeof(MessageListItem) * (msg->entries_num - index));
-            }
+    // Collapse duplicates, the last one wins, but flags of the first one are
+    // preserved (as original code did).
+    int length = 0;
+    for (int index = 0; index < entriesLength; index++) {
+        if (length != 0 && entries[length - 1].num == entries[index].num) {
+            entries[length - 1].audio = entries[index].audio;
+            entries[length - 1].text = entries[index].text;
         } else {
-            msg->entries = (MessageListItem*)internal_malloc(sizeof(MessageListItem));
-            if (msg->entries == nullptr) {
-                return false;
-            }
-            msg->entries_num = 0;
-            index = 0;
+            entries[length++] = entries[index];
         }
+    }
+
+    msg->entries = entries;
+    msg->entries_num = length;
+
+    messageListBuildIndex(msg);
+
+    return true;
+}
 
-        existing_entry = &(msg->entries[index]);
-        existing_entry->flags = 0;
-        existing_entry->audio = nullptr;
-        existing_entry->text = nullptr;
-        msg->entries_num++;
+static void messageListBuildIndex(MessageList* msg)
+{
+    if (msg->index != nullptr) {
+        internal_free(msg->index);
+        msg->index = nullptr;
     }
+    msg->indexBase = 0;
+    msg->indexLength = 0;
 
-    existing_entry->audio = internal_strdup(new_entry->audio);
-    if (existing_entry->audio == nullptr) {
-        return false;
+    if (msg->entries_num == 0) {
+        return;
     }
 
-    existing_entry->text = internal_strdup(new_entry->text);
-    if (existing_entry->text == nullptr) {
-        return false;
+    long long range = static_cast<long long>(msg->entries[msg->entries_num - 1].num) - msg->entries[0].num + 1;
+    if (range > static_cast<long long>(msg->entries_num) * MESSAGE_LIST_INDEX_SPARSENESS + 64) {
+        return;
     }
 
-    existing_entry->num = new_entry->num;
+    int* index = (int*)internal_malloc(sizeof(*index) * range);
+    if (index == nullptr) {
+        return;
+    }
 
-    return true;
+    for (long long slot = 0; slot < range; slot++) {
+        index[slot] = -1;
+    }
+
+    for (int entryIndex = 0; entryIndex < msg->entries_num; entryIndex++) {
+        index[msg->entries[entryIndex].num - msg->entries[0].num] = entryIndex;
+    }
+
+    msg->index = index;
+    msg->indexBase = msg->entries[0].num;
+    msg->indexLength = static_cast<int>(range);
 }
 
 // 0x484F60
@@ -460,8 +537,8 @@ static bool _message_parse_number(int* out_num, const char* str)
     return success;
 }
 
-// Read next message file field, the `str` should be at least
-// `MESSAGE_LIST_ITEM_FIELD_MAX_SIZE` bytes long.
+// Read next message file field from the buffer at [posPtr]. Field is
+// terminated in place, [fieldPtr] receives pointer to it.
 //
 // Returns:
 // 0 - ok
@@ -471,20 +548,21 @@ static bool _message_parse_number(int* out_num, const char* str)
 // 4 - limit exceeded (> `MESSAGE_LIST_ITEM_FIELD_MAX_SIZE`)
 //
 // 0x484FB4
-static int _message_load_field(File* file, char* str)
+static int _message_load_field(char** posPtr, char* end, char** fieldPtr)
 {
-    int ch;
-    int len;
-
-    len = 0;
+    char* pos = *posPtr;
+    char ch;
 
     while (1) {
-        ch = fileReadChar(file);
-        if (ch == -1) {
+        if (pos == end) {
+            *posPtr = pos;
             return 1;
         }
 
+        ch = *pos++;
+
         if (ch == '}') {
+            *posPtr = pos;
             debugPrint("\nError reading message file - mismatched delimiters.\n");
             return 2;
         }
@@ -494,24 +572,33 @@ static int _message_load_field(File* file, char* str)
         }
     }
 
-    while (1) {
-        ch = fileReadChar(file);
+    // Newlines are dropped, so the field is compacted in place.
+    char* field = pos;
+    char* dest = pos;
+    int len = 0;
 
-        if (ch == -1) {
+    while (1) {
+        if (pos == end) {
+            *posPtr = pos;
             debugPrint("\nError reading message file - EOF reached.\n");
             return 3;
         }
 
+        ch = *pos++;
+
         if (ch == '}') {
-            *(str + len) = '\0';
+            *dest = '\0';
+            *fieldPtr = field;
+            *posPtr = pos;
             return 0;
         }
 
         if (ch != '\n') {
-            *(str + len) = ch;
+            *dest++ = ch;
             len++;
 
             if (len >= MESSAGE_LIST_ITEM_FIELD_MAX_SIZE) {
+                *posPtr = pos;
                 debugPrint("\nError reading message file - text exceeds limit.\n");
                 return 4;
             }
@@ -70,6 +70,16 @@ typedef struct MessageListItem {
 typedef struct MessageList {
     int entries_num;
     MessageListItem* entries;
+
+    // CE: Contents of loaded files, texts of entries point into them. See
+    // |messageListLoad|.
+    void* buffers;
+
+    // CE: Dense index of entries by number (or `nullptr` if numbers are too
+    // sparse).
+    int* index;
+    int indexBase;
+    int indexLength;
 } MessageList;
 
 int badwordsInit();
@@ -201,7 +201,9 @@ static void movieFreeImpl(void* ptr)
 // 0x48662C
 static bool movieReadImpl(void* handle, void* buf, int count)
 {
-    return fileRead(buf, 1, count, (File*)handle) == count;
+    // CE: Bypass `fileRead` - it reports read progress to the loading screen,
+    // and movie data is read ahead on a separate thread.
+    return xfileRead(buf, 1, count, (File*)handle) == count;
 }
 
 // 0x486654
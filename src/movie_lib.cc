@@ -6,8 +6,13 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "audio_engine.h"
 #include "delay.h"
 #include "platform_compat.h"
@@ -30,6 +35,15 @@ typedef struct MveHeader {
 } MveHeader;
 #pragma pack()
 
+// CE: Number of records (chunks in MVE terminology) read from movie file ahead
+// of the playback.
+#define MVE_IO_READ_AHEAD_LENGTH (8)
+
+typedef struct MveRecord {
+    unsigned char* data;
+    unsigned int capacity;
+} MveRecord;
+
 static void MVE_MemInit(MveMem* mem, unsigned int size, void* ptr);
 static void MVE_MemFree(MveMem* mem);
 static int _sub_4F4B5();
@@ -65,6 +79,15 @@ static int _MVE_sndDecompM16(unsigned short* a1, unsigned char* a2, int a3, int
 static int _MVE_sndDecompS16(unsigned short* a1, unsigned char* a2, int a3, int a4);
 static void _nfPkConfig();
 static void _nfPkDecomp(unsigned char* buf, unsigned char* a2, int a3, int a4, int a5, int a6);
+static void ioReadAheadStart();
+static void ioReadAheadStop();
+static void ioReadAheadProc();
+static unsigned char* ioPeekRecord();
+static void nfDecompStart();
+static void nfDecompStop();
+static void nfDecompProc();
+static void nfDecompAhead();
+static void nfDecompWait();
 
 // 0x51EBE0
 static unsigned short word_51EBE0[256] = {
@@ -410,6 +433,34 @@ static unsigned char* nf_buf_prv;
 static int gMveSoundBuffer = -1;
 static unsigned int gMveBufferBytes;
 
+// CE: Movie records are read on a separate thread into a small ring. The
+// record at [gMveIoTail - 1] is the one being played and is never touched by
+// the reader.
+static std::thread gMveIoThread;
+static std::mutex gMveIoMutex;
+static std::condition_variable gMveIoCondition;
+static MveRecord gMveIoRecords[MVE_IO_READ_AHEAD_LENGTH];
+static unsigned int gMveIoHead;
+static unsigned int gMveIoTail;
+static bool gMveIoEnd;
+static bool gMveIoStop;
+static bool gMveIoActive = false;
+
+// CE: Video chunk of the next frame is decoded on a separate thread while the
+// main thread waits for the next frame deadline. See `nfDecompAhead`.
+static std::thread gMveDecompThread;
+static std::mutex gMveDecompMutex;
+static std::condition_variable gMveDecompCondition;
+static unsigned char* gMveDecompMap;
+static unsigned short* gMveDecompChunk;
+static bool gMveDecompPending;
+
+// Set when the chunk being decoded belongs to the record following the current
+// one.
+static bool gMveDecompNextRecord;
+static bool gMveDecompStop;
+static bool gMveDecompActive = false;
+
 // 0x4F4800
 void MveSetMemory(MveMallocFunc* malloc_func, MveFreeFunc* free_func)
 {
@@ -492,6 +543,10 @@ void MVE_rmFrameCounts(int* frame_count_ptr, int* frame_drop_count_ptr)
 // 0x4F4BF0
 int MVE_rmPrepMovie(void* handle, int dx, int dy, unsigned char track)
 {
+    // CE: Make sure nothing from the previous movie is still running.
+    nfDecompStop();
+    ioReadAheadStop();
+
     rm_dx = dx;
     rm_dy = dy;
     rm_track_bit = 1 << track;
@@ -505,6 +560,9 @@ int MVE_rmPrepMovie(void* handle, int dx, int dy, unsigned char track)
         return -8;
     }
 
+    ioReadAheadStart();
+    nfDecompStart();
+
     rm_p = ioNextRecord();
     rm_len = 0;
 
@@ -595,6 +653,28 @@ static unsigned char* ioNextRecord()
 {
     unsigned char* buf;
 
+    // CE: The record being released might still be referenced by the video
+    // chunk decoded in the background.
+    if (!gMveDecompNextRecord) {
+        nfDecompWait();
+    }
+    gMveDecompNextRecord = false;
+
+    if (gMveIoActive) {
+        std::unique_lock<std::mutex> lock(gMveIoMutex);
+        gMveIoCondition.wait(lock, []() { return gMveIoHead != gMveIoTail || gMveIoEnd; });
+
+        if (gMveIoHead == gMveIoTail) {
+            return nullptr;
+        }
+
+        buf = gMveIoRecords[gMveIoTail % MVE_IO_READ_AHEAD_LENGTH].data;
+        gMveIoTail++;
+        gMveIoCondition.notify_all();
+
+        return buf;
+    }
+
     buf = (unsigned char*)ioRead((io_next_hdr & 0xFFFF) + 4);
     if (buf == nullptr) {
         return nullptr;
@@ -714,6 +794,8 @@ LABEL_5:
                 v10 = v1[2];
             }
 
+            nfDecompWait();
+
             if (!nfConfig(v1[0], v1[1], v10, v9)) {
                 MVE_rmEndMovie();
                 return -5;
@@ -727,6 +809,8 @@ LABEL_5:
 
             continue;
         case 7:
+            nfDecompWait();
+
             ++rm_FrameCount;
 
             v18 = 0;
@@ -758,6 +842,9 @@ LABEL_5:
             rm_p = (unsigned char*)v1;
             rm_len = v0;
 
+            // CE: Frame is presented, start decoding the next one.
+            nfDecompAhead();
+
             return 0;
         case 8:
         case 9:
@@ -796,6 +883,15 @@ LABEL_5:
                 break;
             }
 
+            // CE: Already decoded ahead (surfaces are swapped as well).
+            if (v1 == gMveDecompChunk) {
+                nfDecompWait();
+                gMveDecompChunk = nullptr;
+                continue;
+            }
+
+            nfDecompWait();
+
             // swap movie surfaces
             if (v1[6] & 0x01) {
                 movieSwapSurfaces();
@@ -867,8 +963,12 @@ static int _MVE_sndConfigure(int a1, int a2, int a3, int a4, int a5, int a6)
 // 0x4F56C0
 static void MVE_syncSync()
 {
+    int diff;
+
     if (sync_active) {
-        while (sync_time + 1000 * compat_timeGetTime() < 0) {
+        // CE: Sleep instead of spinning, the same way `syncWaitLevel` does.
+        while ((diff = sync_time + 1000 * compat_timeGetTime()) < 0) {
+            delay_ms(-diff / 1000 - 3);
         }
     }
 }
@@ -1282,6 +1382,11 @@ static void palLoadPalette(unsigned char* palette, int start, int count)
 // 0x4F6240
 void MVE_rmEndMovie()
 {
+    // CE: Threads are started before the movie is marked active, so they
+    // need to be stopped regardless.
+    nfDecompStop();
+    ioReadAheadStop();
+
     if (rm_active) {
         syncWait();
         syncRelease();
@@ -1309,6 +1414,12 @@ void MVE_ReleaseMem()
 static void ioRelease()
 {
     MVE_MemFree(&io_mem_buf);
+
+    for (int index = 0; index < MVE_IO_READ_AHEAD_LENGTH; index++) {
+        free(gMveIoRecords[index].data);
+        gMveIoRecords[index].data = nullptr;
+        gMveIoRecords[index].capacity = 0;
+    }
 }
 
 // 0x4F6380
@@ -2336,4 +2447,233 @@ static void _nfPkDecomp(unsigned char* a1, unsigned char* a2, int a3, int a4, in
     }
 }
 
+static void ioReadAheadStart()
+{
+#if !defined(__EMSCRIPTEN__)
+    gMveIoHead = 0;
+    gMveIoTail = 0;
+    gMveIoEnd = false;
+    gMveIoStop = false;
+    gMveIoThread = std::thread(ioReadAheadProc);
+    gMveIoActive = true;
+#endif
+}
+
+static void ioReadAheadStop()
+{
+    if (!gMveIoActive) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gMveIoMutex);
+        gMveIoStop = true;
+    }
+
+    gMveIoCondition.notify_all();
+    gMveIoThread.join();
+
+    gMveIoActive = false;
+}
+
+static void ioReadAheadProc()
+{
+    // Header of the next record to read, owned by this thread while it's
+    // running.
+    unsigned int hdr = io_next_hdr;
+
+    while (1) {
+        {
+            std::unique_lock<std::mutex> lock(gMveIoMutex);
+            gMveIoCondition.wait(lock, []() { return gMveIoStop || gMveIoHead - gMveIoTail < MVE_IO_READ_AHEAD_LENGTH - 1; });
+
+            if (gMveIoStop) {
+                break;
+            }
+        }
+
+        // NOTE: Records are allocated with plain `malloc` since custom
+        // allocator is not thread-safe.
+        MveRecord* record = &(gMveIoRecords[gMveIoHead % MVE_IO_READ_AHEAD_LENGTH]);
+        unsigned int size = (hdr & 0xFFFF) + 4;
+        if (record->capacity < size) {
+            free(record->data);
+            record->data = (unsigned char*)malloc(size + 100);
+            record->capacity = record->data != nullptr ? size + 100 : 0;
+        }
+
+        if (record->data == nullptr || mve_read_func(io_handle, record->data, size) < 1) {
+            std::lock_guard<std::mutex> lock(gMveIoMutex);
+            gMveIoEnd = true;
+            gMveIoCondition.notify_all();
+            break;
+        }
+
+        hdr = *(unsigned int*)(record->data + (hdr & 0xFFFF));
+
+        std::lock_guard<std::mutex> lock(gMveIoMutex);
+        gMveIoHead++;
+        gMveIoCondition.notify_all();
+    }
+}
+
+// Returns record which will be returned by the next `ioNextRecord` call, or
+// `nullptr` if it's not read yet.
+static unsigned char* ioPeekRecord()
+{
+    std::lock_guard<std::mutex> lock(gMveIoMutex);
+    if (gMveIoHead == gMveIoTail) {
+        return nullptr;
+    }
+
+    return gMveIoRecords[gMveIoTail % MVE_IO_READ_AHEAD_LENGTH].data;
+}
+
+static void nfDecompStart()
+{
+#if !defined(__EMSCRIPTEN__)
+    gMveDecompMap = nullptr;
+    gMveDecompChunk = nullptr;
+    gMveDecompPending = false;
+    gMveDecompNextRecord = false;
+    gMveDecompStop = false;
+    gMveDecompThread = std::thread(nfDecompProc);
+    gMveDecompActive = true;
+#endif
+}
+
+static void nfDecompStop()
+{
+    if (!gMveDecompActive) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gMveDecompMutex);
+        gMveDecompStop = true;
+    }
+
+    gMveDecompCondition.notify_all();
+    gMveDecompThread.join();
+
+    gMveDecompChunk = nullptr;
+    gMveDecompNextRecord = false;
+    gMveDecompActive = false;
+}
+
+static void nfDecompProc()
+{
+    std::unique_lock<std::mutex> lock(gMveDecompMutex);
+    while (1) {
+        gMveDecompCondition.wait(lock, []() { return gMveDecompStop || gMveDecompPending; });
+
+        // Pending chunk is always finished, even when stopping, so that
+        // waiters see consistent surfaces.
+        if (gMveDecompPending) {
+            unsigned char* map = gMveDecompMap;
+            unsigned short* chunk = gMveDecompChunk;
+            lock.unlock();
+
+            _nfPkDecomp(map, (unsigned char*)&chunk[7], chunk[2], chunk[3], chunk[4], chunk[5]);
+
+            lock.lock();
+            gMveDecompPending = false;
+            gMveDecompCondition.notify_all();
+            continue;
+        }
+
+        break;
+    }
+}
+
+// Looks for the video chunk of the next frame (in the current record or in the
+// next one if it's already read), and starts decoding it in the background.
+// Does nothing if the next frame reconfigures video, or is shown before being
+// decoded.
+//
+// Only chunks which swap surfaces are decoded ahead. Such chunk writes into
+// the surface that is not on screen, while the presented one is only read as
+// reference.
+static void nfDecompAhead()
+{
+    unsigned char* record;
+    unsigned short* chunk;
+    unsigned char* map;
+    unsigned int hdr;
+    int len;
+    bool nextRecord;
+
+    if (!gMveDecompActive) {
+        return;
+    }
+
+    record = rm_p;
+    len = rm_len;
+    map = nullptr;
+    nextRecord = false;
+
+    while (1) {
+        hdr = *(unsigned int*)(record + len);
+        chunk = (unsigned short*)(record + len + 4);
+        record = (unsigned char*)chunk;
+        len = hdr & 0xFFFF;
+
+        switch ((hdr >> 16) & 0xFF) {
+        case 1:
+            if (nextRecord) {
+                return;
+            }
+
+            record = ioPeekRecord();
+            if (record == nullptr) {
+                return;
+            }
+
+            // Decoding map is reset at record boundary.
+            len = 0;
+            map = nullptr;
+            nextRecord = true;
+            continue;
+        case 15:
+            map = (unsigned char*)chunk;
+            continue;
+        case 17:
+            if ((hdr >> 24) < 3 || map == nullptr || !(chunk[6] & 0x01)) {
+                return;
+            }
+
+            movieSwapSurfaces();
+
+            {
+                std::lock_guard<std::mutex> lock(gMveDecompMutex);
+                gMveDecompMap = map;
+                gMveDecompChunk = chunk;
+                gMveDecompPending = true;
+            }
+
+            gMveDecompNextRecord = nextRecord;
+
+            gMveDecompCondition.notify_all();
+            return;
+        case 0:
+        case 5:
+        case 7:
+            return;
+        default:
+            continue;
+        }
+    }
+}
+
+// Waits for background decoding started by `nfDecompAhead` to complete.
+static void nfDecompWait()
+{
+    if (!gMveDecompActive) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(gMveDecompMutex);
+    gMveDecompCondition.wait(lock, []() { return !gMveDecompPending; });
+}
+
 } // namespace fallout
@@ -267,6 +267,20 @@ typedef struct ObjectData {
     };
 } ObjectData;
 
+// CE: Frame geometry of the object's current art, cached by
+// `_obj_render_object` to reject objects outside of the update rect without
+// locking art. Valid while `fid`, `frame` and `rotation` match the object.
+typedef struct ObjectRenderCache {
+    bool valid;
+    int fid;
+    int frame;
+    int rotation;
+    int width;
+    int height;
+    int xOffset;
+    int yOffset;
+} ObjectRenderCache;
+
 typedef struct Object {
     int id; // obj_id
     int tile; // obj_tile_num
@@ -288,6 +302,7 @@ typedef struct Object {
     int sid; // obj_sid
     Object* owner;
     int scriptIndex;
+    ObjectRenderCache renderCache;
 } Object;
 
 typedef struct ObjectListNode {
@@ -24,6 +24,7 @@
 #include "scripts.h"
 #include "settings.h"
 #include "sfall_config.h"
+#include "stat.h"
 #include "svga.h"
 #include "text_object.h"
 #include "tile.h"
@@ -53,6 +54,8 @@ static int objectListNodeCreate(ObjectListNode** nodePtr);
 static void objectListNodeDestroy(ObjectListNode** nodePtr);
 static int objectGetListNode(Object* obj, ObjectListNode** out_node, ObjectListNode** out_prev_node);
 static void _obj_insert(ObjectListNode* ptr);
+static void objectListNodeUnlink(ObjectListNode* node, ObjectListNode* previousNode);
+static bool objectTileIsEmpty(int tile, int elevation);
 static int _obj_remove(ObjectListNode* a1, ObjectListNode* a2);
 static int _obj_connect_to_tile(ObjectListNode* node, int tile_index, int elev, Rect* rect);
 static int _obj_adjust_light(Object* obj, int a2, Rect* rect);
@@ -103,6 +106,14 @@ static int _outlineCount = 0;
 // 0x519628
 static ObjectListNode* gObjectListHead = nullptr;
 
+// CE: Number of objects checked against update rect and actually drawn by
+// `_obj_render_object`, see `objectsGetRenderCounters`.
+static unsigned int gObjectRenderVisitedCount = 0;
+static unsigned int gObjectRenderDrawnCount = 0;
+
+// CE: Storage for object list nodes.
+static MemoryPool gObjectListNodePool = MEMORY_POOL_INITIALIZER("ObjectListNode", ObjectListNode, 1024);
+
 // 0x51962C
 static int _centerToUpperLeft = 0;
 
@@ -249,6 +260,12 @@ static Rect gObjectsUpdateAreaPixelBounds;
 // 0x639DA0
 static ObjectListNode* gObjectListHeadByTile[HEX_GRID_SIZE];
 
+// CE: Number of objects in `gObjectListHeadByTile` lists by elevation. These
+// lists are shared by all elevations, so without the counts blocking checks
+// have to walk objects on other floors. Most tiles visited by pathfinder and
+// line of fire checks have no objects on the current elevation at all.
+static unsigned short gObjectTileCounts[ELEVATION_COUNT][HEX_GRID_SIZE];
+
 // 0x660EA0
 static unsigned char _glassGrayTable[256];
 
@@ -303,6 +320,7 @@ int objectsInit(unsigned char* buf, int width, int height, int pitch)
     gObjectsUpdateAreaHexSize = gObjectsUpdateAreaHexWidth * gObjectsUpdateAreaHexHeight;
 
     memset(gObjectListHeadByTile, 0, sizeof(gObjectListHeadByTile));
+    memset(gObjectTileCounts, 0, sizeof(gObjectTileCounts));
 
     if (_obj_offset_table_init() == -1) {
         return -1;
@@ -392,6 +410,8 @@ void objectsReset()
 void objectsExit()
 {
     if (gObjectsInitialized) {
+        debugPrint("\nObjects rendered: %u of %u visited\n", gObjectRenderDrawnCount, gObjectRenderVisitedCount);
+
         gDude->flags &= ~OBJECT_NO_REMOVE;
         gEgg->flags &= ~OBJECT_NO_REMOVE;
 
@@ -410,6 +430,8 @@ void objectsExit()
         _obj_order_table_exit();
 
         _obj_offset_table_exit();
+
+        memoryPoolExit(&gObjectListNodePool);
     }
 }
 
@@ -418,6 +440,9 @@ int objectRead(Object* obj, File* stream)
 {
     int field_74;
 
+    // CE: Object might have been allocated without clearing.
+    obj->renderCache.valid = false;
+
     if (fileReadInt32(stream, &(obj->id)) == -1) return -1;
     if (fileReadInt32(stream, &(obj->tile)) == -1) return -1;
     if (fileReadInt32(stream, &(obj->x)) == -1) return -1;
@@ -582,6 +607,10 @@ static int objectLoadAllInternal(File* stream)
                             debugPrint("Error loading inventory\n");
                             return -1;
                         }
+
+                        // CE: Owner is used to propagate inventory changes
+                        // to cached aggregates, see |itemInvalidateInventory|.
+                        inventoryItem->item->owner = objectListNode->obj;
                     } else {
                         if (_obj_load_obj(stream, &(inventoryItem->item), elevation, objectListNode->obj) == -1) {
                             return -1;
@@ -791,7 +820,8 @@ void _obj_render_pre_roof(Rect* rect, int elevation)
         int offsetIndex = _orderTable[parity][i];
         if (updateAreaHexHeight > _offsetDivTable[offsetIndex] && updateAreaHexWidth > _offsetModTable[offsetIndex]) {
             int tile = upperLeftTile + _offsetTable[parity][offsetIndex];
-            ObjectListNode* objectListNode = hexGridTileIsValid(tile)
+            // CE: Skip tiles with objects on other elevations only.
+            ObjectListNode* objectListNode = hexGridTileIsValid(tile) && !objectTileIsEmpty(tile, elevation)
                 ? gObjectListHeadByTile[tile]
                 : nullptr;
 
@@ -891,6 +921,14 @@ void _obj_render_post_roof(Rect* rect, int elevation)
     }
 }
 
+// CE: Returns number of objects considered for rendering and number of objects
+// that intersected update rect and were drawn since the start of the game.
+void objectsGetRenderCounters(unsigned int* visitedPtr, unsigned int* drawnPtr)
+{
+    *visitedPtr = gObjectRenderVisitedCount;
+    *drawnPtr = gObjectRenderDrawnCount;
+}
+
 // 0x489A84
 int objectCreateWithFidPid(Object** objectPtr, int fid, int pid)
 {
@@ -1109,25 +1147,20 @@ int _obj_disconnect(Object* obj, Rect* rect)
         return -1;
     }
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     if (_obj_adjust_light(obj, 1, rect) == -1) {
         if (rect != nullptr) {
             objectGetRect(obj, rect);
         }
     }
 
-    if (prev_node != nullptr) {
-        prev_node->next = node->next;
-    } else {
-        int tile = node->obj->tile;
-        if (tile == -1) {
-            gObjectListHead = gObjectListHead->next;
-        } else {
-            gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-        }
-    }
+    objectListNodeUnlink(node, prev_node);
 
     if (node != nullptr) {
-        internal_free(node);
+        // NOTE: Uninline.
+        objectListNodeDestroy(&node);
     }
 
     obj->tile = -1;
@@ -1154,16 +1187,7 @@ int _obj_offset(Object* obj, int x, int y, Rect* rect)
             objectGetRect(gEgg, &eggRect);
             rectCopy(rect, &eggRect);
 
-            if (previousNode != nullptr) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    gObjectListHead = gObjectListHead->next;
-                } else {
-                    gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-                }
-            }
+            objectListNodeUnlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1178,16 +1202,7 @@ int _obj_offset(Object* obj, int x, int y, Rect* rect)
             _obj_offset(gEgg, x, y, nullptr);
             rectUnion(rect, &eggRect, rect);
         } else {
-            if (previousNode != nullptr) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    gObjectListHead = gObjectListHead->next;
-                } else {
-                    gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-                }
-            }
+            objectListNodeUnlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1203,16 +1218,7 @@ int _obj_offset(Object* obj, int x, int y, Rect* rect)
         if (rect != nullptr) {
             objectGetRect(obj, rect);
 
-            if (previousNode != nullptr) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    gObjectListHead = gObjectListHead->next;
-                } else {
-                    gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-                }
-            }
+            objectListNodeUnlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1229,16 +1235,7 @@ int _obj_offset(Object* obj, int x, int y, Rect* rect)
 
             rectUnion(rect, &objectRect, rect);
         } else {
-            if (previousNode != nullptr) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    gObjectListHead = gObjectListHead->next;
-                } else {
-                    gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-                }
-            }
+            objectListNodeUnlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1277,16 +1274,7 @@ int _obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
             }
         }
 
-        if (previousNode != nullptr) {
-            previousNode->next = node->next;
-        } else {
-            int tile = node->obj->tile;
-            if (tile == -1) {
-                gObjectListHead = gObjectListHead->next;
-            } else {
-                gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-            }
-        }
+        objectListNodeUnlink(node, previousNode);
 
         a1->tile = -1;
         a1->elevation = elevation;
@@ -1305,16 +1293,7 @@ int _obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
                 objectGetRect(a1, a5);
             }
 
-            if (previousNode != nullptr) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile != -1) {
-                    gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-                } else {
-                    gObjectListHead = gObjectListHead->next;
-                }
-            }
+            objectListNodeUnlink(node, previousNode);
 
             a1->elevation = elevation;
             v22 = 1;
@@ -1387,16 +1366,7 @@ int objectSetLocation(Object* obj, int tile, int elevation, Rect* rect)
     }
 
     int oldElevation = obj->elevation;
-    if (prevNode != nullptr) {
-        prevNode->next = node->next;
-    } else {
-        int tileIndex = node->obj->tile;
-        if (tileIndex == -1) {
-            gObjectListHead = gObjectListHead->next;
-        } else {
-            gObjectListHeadByTile[tileIndex] = gObjectListHeadByTile[tileIndex]->next;
-        }
-    }
+    objectListNodeUnlink(node, prevNode);
 
     if (_obj_connect_to_tile(node, tile, elevation, rect) == -1) {
         return -1;
@@ -1834,6 +1804,9 @@ int objectShow(Object* obj, Rect* rect)
     obj->flags &= ~OBJECT_HIDDEN;
     obj->outline &= ~OUTLINE_DISABLED;
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     if (_obj_adjust_light(obj, 0, rect) == -1) {
         if (rect != nullptr) {
             objectGetRect(obj, rect);
@@ -1870,6 +1843,9 @@ int objectHide(Object* object, Rect* rect)
 
     object->flags |= OBJECT_HIDDEN;
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     if ((object->outline & OUTLINE_TYPE_MASK) != 0) {
         object->outline |= OUTLINE_DISABLED;
     }
@@ -1937,16 +1913,7 @@ int _obj_toggle_flat(Object* object, Rect* rect)
     if (rect != nullptr) {
         objectGetRect(object, rect);
 
-        if (previousNode != nullptr) {
-            previousNode->next = node->next;
-        } else {
-            int tile_index = node->obj->tile;
-            if (tile_index == -1) {
-                gObjectListHead = gObjectListHead->next;
-            } else {
-                gObjectListHeadByTile[tile_index] = gObjectListHeadByTile[tile_index]->next;
-            }
-        }
+        objectListNodeUnlink(node, previousNode);
 
         object->flags ^= OBJECT_FLAT;
 
@@ -1954,16 +1921,7 @@ int _obj_toggle_flat(Object* object, Rect* rect)
         objectGetRect(object, &v1);
         rectUnion(rect, &v1, rect);
     } else {
-        if (previousNode != nullptr) {
-            previousNode->next = node->next;
-        } else {
-            int tile = node->obj->tile;
-            if (tile == -1) {
-                gObjectListHead = gObjectListHead->next;
-            } else {
-                gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-            }
-        }
+        objectListNodeUnlink(node, previousNode);
 
         object->flags ^= OBJECT_FLAT;
 
@@ -2036,6 +1994,8 @@ int _obj_inven_free(Inventory* inventory)
         inventory->length = 0;
     }
 
+    itemFreeInventoryCache(inventory);
+
     return 0;
 }
 
@@ -2393,6 +2353,10 @@ void objectGetRect(Object* obj, Rect* rect)
 // 0x48B7F8
 bool _obj_occupied(int tile, int elevation)
 {
+    if (objectTileIsEmpty(tile, elevation)) {
+        return false;
+    }
+
     ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         if (objectListNode->obj->elevation == elevation
@@ -2417,7 +2381,7 @@ Object* _obj_blocking_at(Object* excludeObj, int tile, int elev)
         return nullptr;
     }
 
-    objectListNode = gObjectListHeadByTile[tile];
+    objectListNode = objectTileIsEmpty(tile, elev) ? nullptr : gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         obj = objectListNode->obj;
         if (obj->elevation == elev) {
@@ -2435,7 +2399,7 @@ Object* _obj_blocking_at(Object* excludeObj, int tile, int elev)
 
     for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
         int neighboor = tileGetTileInDirection(tile, rotation, 1);
-        if (hexGridTileIsValid(neighboor)) {
+        if (hexGridTileIsValid(neighboor) && !objectTileIsEmpty(neighboor, elev)) {
             objectListNode = gObjectListHeadByTile[neighboor];
             while (objectListNode != nullptr) {
                 obj = objectListNode->obj;
@@ -2466,7 +2430,7 @@ Object* _obj_shoot_blocking_at(Object* excludeObj, int tile, int elev)
         return nullptr;
     }
 
-    ObjectListNode* objectListItem = gObjectListHeadByTile[tile];
+    ObjectListNode* objectListItem = objectTileIsEmpty(tile, elev) ? nullptr : gObjectListHeadByTile[tile];
     while (objectListItem != nullptr) {
         Object* candidate = objectListItem->obj;
         if (candidate->elevation == elev) {
@@ -2486,7 +2450,7 @@ Object* _obj_shoot_blocking_at(Object* excludeObj, int tile, int elev)
 
     for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
         int adjacentTile = tileGetTileInDirection(tile, rotation, 1);
-        if (!hexGridTileIsValid(adjacentTile)) {
+        if (!hexGridTileIsValid(adjacentTile) || objectTileIsEmpty(adjacentTile, elev)) {
             continue;
         }
 
@@ -2522,7 +2486,7 @@ Object* _obj_ai_blocking_at(Object* excludeObj, int tile, int elevation)
         return nullptr;
     }
 
-    ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
+    ObjectListNode* objectListNode = objectTileIsEmpty(tile, elevation) ? nullptr : gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         Object* object = objectListNode->obj;
         if (object->elevation == elevation) {
@@ -2546,7 +2510,7 @@ Object* _obj_ai_blocking_at(Object* excludeObj, int tile, int elevation)
 
     for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
         int candidate = tileGetTileInDirection(tile, rotation, 1);
-        if (!hexGridTileIsValid(candidate)) {
+        if (!hexGridTileIsValid(candidate) || objectTileIsEmpty(candidate, elevation)) {
             continue;
         }
 
@@ -2605,6 +2569,10 @@ int _obj_scroll_blocking_at(int tile, int elev)
 // 0x48BB88
 Object* _obj_sight_blocking_at(Object* excludeObj, int tile, int elevation)
 {
+    if (objectTileIsEmpty(tile, elevation)) {
+        return nullptr;
+    }
+
     ObjectListNode* objectListNode = gObjectListHeadByTile[tile];
     while (objectListNode != nullptr) {
         Object* object = objectListNode->obj;
@@ -3677,6 +3645,9 @@ int _obj_load_dude(File* stream)
 
     memcpy(gDude, temp, sizeof(*gDude));
 
+    // CE: Dude's inventory is replaced.
+    itemInvalidateInventory(gDude);
+
     gDude->flags |= OBJECT_NO_SAVE;
 
     scriptsClearDudeScript();
@@ -3774,6 +3745,13 @@ static void objectDeallocate(Object** objectPtr)
         return;
     }
 
+    // CE: Make sure cached stats, inventories, lines of fire and reachability
+    // field are not reused if this address is taken by another object.
+    statsInvalidateCache();
+    itemFreeInventoryCache(&((*objectPtr)->data.inventory));
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     {
         // Sometimes game scripts are using object
         // after it has been destroyed.
@@ -3811,7 +3789,7 @@ static int objectListNodeCreate(ObjectListNode** nodePtr)
         return -1;
     }
 
-    ObjectListNode* node = *nodePtr = (ObjectListNode*)internal_malloc(sizeof(*node));
+    ObjectListNode* node = *nodePtr = (ObjectListNode*)memoryPoolAlloc(&gObjectListNodePool);
     if (node == nullptr) {
         return -1;
     }
@@ -3835,7 +3813,7 @@ static void objectListNodeDestroy(ObjectListNode** nodePtr)
         return;
     }
 
-    internal_free(*nodePtr);
+    memoryPoolFree(&gObjectListNodePool, *nodePtr);
 
     *nodePtr = nullptr;
 }
@@ -3895,6 +3873,9 @@ static void _obj_insert(ObjectListNode* objectListNode)
         return;
     }
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     if (objectListNode->obj->tile == -1) {
         objectListNodePtr = &gObjectListHead;
     } else {
@@ -3945,6 +3926,41 @@ static void _obj_insert(ObjectListNode* objectListNode)
 
     objectListNode->next = *objectListNodePtr;
     *objectListNodePtr = objectListNode;
+
+    if (objectListNode->obj->tile != -1) {
+        gObjectTileCounts[objectListNode->obj->elevation][objectListNode->obj->tile]++;
+    }
+}
+
+// CE: Removes [node] from the object list it belongs to (based on its tile),
+// [previousNode] is the node preceding it in that list or `nullptr` if [node]
+// is the head.
+static void objectListNodeUnlink(ObjectListNode* node, ObjectListNode* previousNode)
+{
+    int tile = node->obj->tile;
+
+    if (previousNode != nullptr) {
+        previousNode->next = node->next;
+    } else {
+        if (tile == -1) {
+            gObjectListHead = gObjectListHead->next;
+        } else {
+            gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
+        }
+    }
+
+    if (tile != -1) {
+        gObjectTileCounts[node->obj->elevation][tile]--;
+    }
+}
+
+// CE: Returns `true` if there are definitely no objects on [tile] at
+// [elevation].
+static bool objectTileIsEmpty(int tile, int elevation)
+{
+    return hexGridTileIsValid(tile)
+        && elevationIsValid(elevation)
+        && gObjectTileCounts[elevation][tile] == 0;
 }
 
 // 0x48DA58
@@ -3958,6 +3974,9 @@ static int _obj_remove(ObjectListNode* a1, ObjectListNode* a2)
         return -1;
     }
 
+    combatInvalidateLineOfFireCache();
+    pathfinderInvalidateReachability();
+
     _obj_inven_free(&(a1->obj->data.inventory));
 
     if (a1->obj->sid != -1) {
@@ -3966,16 +3985,7 @@ static int _obj_remove(ObjectListNode* a1, ObjectListNode* a2)
     }
 
     if (a1 != a2) {
-        if (a2 != nullptr) {
-            a2->next = a1->next;
-        } else {
-            int tile = a1->obj->tile;
-            if (tile == -1) {
-                gObjectListHead = gObjectListHead->next;
-            } else {
-                gObjectListHeadByTile[tile] = gObjectListHeadByTile[tile]->next;
-            }
-        }
+        objectListNodeUnlink(a1, a2);
     }
 
     // NOTE: Uninline.
@@ -4945,14 +4955,34 @@ static void _obj_render_object(Object* object, Rect* rect, int light)
         return;
     }
 
-    CacheEntry* cacheEntry;
-    Art* art = artLock(object->fid, &cacheEntry);
-    if (art == nullptr) {
-        return;
+    gObjectRenderVisitedCount++;
+
+    // CE: Art is locked only when the object is actually drawn, frame geometry
+    // needed to check it against update rect is cached in the object.
+    CacheEntry* cacheEntry = nullptr;
+    Art* art = nullptr;
+    ObjectRenderCache* renderCache = &(object->renderCache);
+    if (!renderCache->valid
+        || renderCache->fid != object->fid
+        || renderCache->frame != object->frame
+        || renderCache->rotation != object->rotation) {
+        art = artLock(object->fid, &cacheEntry);
+        if (art == nullptr) {
+            return;
+        }
+
+        renderCache->valid = true;
+        renderCache->fid = object->fid;
+        renderCache->frame = object->frame;
+        renderCache->rotation = object->rotation;
+        renderCache->width = artGetWidth(art, object->frame, object->rotation);
+        renderCache->height = artGetHeight(art, object->frame, object->rotation);
+        renderCache->xOffset = art->xOffsets[object->rotation];
+        renderCache->yOffset = art->yOffsets[object->rotation];
     }
 
-    int frameWidth = artGetWidth(art, object->frame, object->rotation);
-    int frameHeight = artGetHeight(art, object->frame, object->rotation);
+    int frameWidth = renderCache->width;
+    int frameHeight = renderCache->height;
 
     Rect objectRect;
     if (object->tile == -1) {
@@ -4967,8 +4997,8 @@ static void _obj_render_object(Object* object, Rect* rect, int light)
         objectScreenX += 16;
         objectScreenY += 8;
 
-        objectScreenX += art->xOffsets[object->rotation];
-        objectScreenY += art->yOffsets[object->rotation];
+        objectScreenX += renderCache->xOffset;
+        objectScreenY += renderCache->yOffset;
 
         objectScreenX += object->x;
         objectScreenY += object->y;
@@ -4983,10 +5013,21 @@ static void _obj_render_object(Object* object, Rect* rect, int light)
     }
 
     if (rectIntersection(&objectRect, rect, &objectRect) != 0) {
-        artUnlock(cacheEntry);
+        if (art != nullptr) {
+            artUnlock(cacheEntry);
+        }
         return;
     }
 
+    if (art == nullptr) {
+        art = artLock(object->fid, &cacheEntry);
+        if (art == nullptr) {
+            return;
+        }
+    }
+
+    gObjectRenderDrawnCount++;
+
     unsigned char* src = artGetFrameData(art, object->frame, object->rotation);
     unsigned char* src2 = src;
     int v50 = objectRect.left - object->sx;
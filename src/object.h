@@ -29,6 +29,7 @@ int objectLoadAll(File* stream);
 int objectSaveAll(File* stream);
 void _obj_render_pre_roof(Rect* rect, int elevation);
 void _obj_render_post_roof(Rect* rect, int elevation);
+void objectsGetRenderCounters(unsigned int* visitedPtr, unsigned int* drawnPtr);
 int objectCreateWithFidPid(Object** objectPtr, int fid, int pid);
 int objectCreateWithPid(Object** objectPtr, int pid);
 int _obj_copy(Object** a1, Object* a2);
@@ -1602,6 +1602,8 @@ static int _partyMemberCopyLevelInfo(Object* critter, int stagePid)
         proto->critter.data.skills[skill] = stageProto->critter.data.skills[skill];
     }
 
+    statsInvalidateCache();
+
     critter->data.critter.hp = critterGetStat(critter, STAT_MAXIMUM_HIT_POINTS);
 
     if (armor != nullptr) {
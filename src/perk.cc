@@ -261,6 +261,8 @@ int perksLoad(File* stream)
         }
     }
 
+    statsInvalidateCache();
+
     return 0;
 }
 
@@ -428,6 +430,8 @@ static void perkResetRanks()
             ranksData->ranks[perk] = 0;
         }
     }
+
+    statsInvalidateCache();
 }
 
 // 0x496A5C
@@ -443,6 +447,7 @@ int perkAdd(Object* critter, int perk)
 
     PerkRankData* ranksData = perkGetRankData(critter);
     ranksData->ranks[perk] += 1;
+    statsInvalidateCache();
 
     perkAddEffect(critter, perk);
 
@@ -467,6 +472,7 @@ int perkAddForce(Object* critter, int perk)
     }
 
     ranksData->ranks[perk] += 1;
+    statsInvalidateCache();
 
     perkAddEffect(critter, perk);
 
@@ -489,6 +495,7 @@ int perkRemove(Object* critter, int perk)
     }
 
     ranksData->ranks[perk] -= 1;
+    statsInvalidateCache();
 
     perkRemoveEffect(critter, perk);
 
@@ -0,0 +1,9 @@
+#pragma once
+
+#define _BUILD_AUTHOR "agent"
+#define _BUILD_BRANCH "master"
+#define _BUILD_HASH   "360f999"
+#define _BUILD_VER    ""
+#define _BUILD_DATE   "Oct 19 2026 13:40:47"
+
+#define CI_BUILD 0
@@ -1,6 +1,8 @@
 #include "platform_compat.h"
 
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -9,7 +11,6 @@
 #include <stdlib.h>
 #else
 #include <dirent.h>
-#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -362,6 +363,30 @@ int compat_access(const char* path, int mode)
     return access(nativePath, mode);
 }
 
+// Retrieves modification time and size of a regular file. Returns -1 if file
+// does not exist.
+int compat_stat(const char* path, time_t* modificationTimePtr, long* sizePtr)
+{
+    char nativePath[COMPAT_MAX_PATH];
+    strcpy(nativePath, path);
+    compat_windows_path_to_native(nativePath);
+    compat_resolve_path(nativePath);
+
+    struct stat info;
+    if (stat(nativePath, &info) != 0) {
+        return -1;
+    }
+
+    if ((info.st_mode & S_IFMT) != S_IFREG) {
+        return -1;
+    }
+
+    *modificationTimePtr = info.st_mtime;
+    *sizePtr = static_cast<long>(info.st_size);
+
+    return 0;
+}
+
 char* compat_strdup(const char* string)
 {
     return SDL_strdup(string);
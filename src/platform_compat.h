@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <zlib.h>
 
@@ -42,6 +43,7 @@ int compat_rename(const char* oldFileName, const char* newFileName);
 void compat_windows_path_to_native(char* path);
 void compat_resolve_path(char* path);
 int compat_access(const char* path, int mode);
+int compat_stat(const char* path, time_t* modificationTimePtr, long* sizePtr);
 char* compat_strdup(const char* string);
 long getFileSize(FILE* stream);
 
@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "art.h"
 #include "character_editor.h"
 #include "combat.h"
@@ -36,9 +39,9 @@ static int protoSceneryDataWrite(SceneryProtoData* scenery_data, int type, File*
 static int protoWrite(Proto* buf, File* stream);
 static int _proto_load_pid(int pid, Proto** out_proto);
 static int _proto_find_free_subnode(int type, Proto** out_ptr);
-static void _proto_remove_some_list(int type);
 static void _proto_remove_list(int type);
 static int _proto_new_id(int type);
+static void protoIndexSet(int pid, Proto* proto);
 
 // 0x50CF3C
 static char _aProto_0[] = "proto\\";
@@ -67,6 +70,11 @@ static ProtoList _protoLists[11] = {
     { nullptr, nullptr, 0, 0 },
 };
 
+// CE: Loaded protos of every type indexed by pid index (lower 24 bits of
+// pid), sized from number of entries in .lst files. Protos are still owned by
+// |_protoLists|, this index only replaces linear search in |protoGetProto|.
+static std::vector<Proto*> gProtoIndex[11];
+
 // 0x51C340
 static const size_t _proto_sizes[11] = {
     sizeof(ItemProto), // 0x84
@@ -914,6 +922,8 @@ int _proto_dude_init(const char* path)
     proto->critter.data.killType = 0;
     proto->critter.data.damageType = 0;
 
+    statsInvalidateCache();
+
     _proto_dude_update_gender();
     _inven_reset_dude();
 
@@ -1544,6 +1554,8 @@ static int _proto_header_load()
         }
 
         fileClose(stream);
+
+        gProtoIndex[index].assign(ptr->max_entries_num, nullptr);
     }
 
     return 0;
@@ -1973,6 +1985,9 @@ static int _proto_load_pid(int pid, Proto** protoPtr)
     }
 
     fileClose(stream);
+
+    protoIndexSet(pid, *protoPtr);
+
     return 0;
 }
 
@@ -2066,26 +2081,9 @@ int proto_new(int* pid, int type)
         return -1;
     }
 
-    return 0;
-}
+    protoIndexSet(*pid, proto);
 
-// Evict top most proto cache block.
-//
-// 0x4A2040
-static void _proto_remove_some_list(int type)
-{
-    ProtoList* protoList = &(_protoLists[type]);
-    ProtoListExtent* protoListExtent = protoList->head;
-    if (protoListExtent != nullptr) {
-        protoList->length--;
-        protoList->head = protoListExtent->next;
-
-        for (int index = 0; index < protoListExtent->length; index++) {
-            internal_free(protoListExtent->proto[index]);
-        }
-
-        internal_free(protoListExtent);
-    }
+    return 0;
 }
 
 // Clear proto cache of given type.
@@ -2108,6 +2106,10 @@ static void _proto_remove_list(int type)
     protoList->head = nullptr;
     protoList->tail = nullptr;
     protoList->length = 0;
+
+    std::fill(gProtoIndex[type].begin(), gProtoIndex[type].end(), nullptr);
+
+    statsInvalidateCache();
 }
 
 // Clear all proto cache.
@@ -2135,28 +2137,37 @@ int protoGetProto(int pid, Proto** protoPtr)
         return 0;
     }
 
-    ProtoList* protoList = &(_protoLists[PID_TYPE(pid)]);
-    ProtoListExtent* protoListExtent = protoList->head;
-    while (protoListExtent != nullptr) {
-        for (int index = 0; index < protoListExtent->length; index++) {
-            Proto* proto = (Proto*)protoListExtent->proto[index];
-            if (pid == proto->pid) {
-                *protoPtr = proto;
-                return 0;
-            }
-        }
-        protoListExtent = protoListExtent->next;
+    // CE: Lookup loaded proto directly by pid index instead of scanning
+    // proto list. Loaded protos are no longer evicted when list grows beyond
+    // |PROTO_LIST_MAX_ENTRIES|, so the same protos are not read from disk over
+    // and over again (which is also the reason pointers returned from this
+    // function are now stable until proto reset).
+    int type = PID_TYPE(pid);
+    if (type < 0 || type >= 11) {
+        return -1;
     }
 
-    if (protoList->head != nullptr && protoList->tail != nullptr) {
-        if (PROTO_LIST_EXTENT_SIZE * protoList->length - (PROTO_LIST_EXTENT_SIZE - protoList->tail->length) > PROTO_LIST_MAX_ENTRIES) {
-            _proto_remove_some_list(PID_TYPE(pid));
-        }
+    size_t index = pid & 0xFFFFFF;
+    if (index < gProtoIndex[type].size() && gProtoIndex[type][index] != nullptr) {
+        *protoPtr = gProtoIndex[type][index];
+        return 0;
     }
 
     return _proto_load_pid(pid, protoPtr);
 }
 
+static void protoIndexSet(int pid, Proto* proto)
+{
+    std::vector<Proto*>& protoIndex = gProtoIndex[PID_TYPE(pid)];
+
+    size_t index = pid & 0xFFFFFF;
+    if (index >= protoIndex.size()) {
+        protoIndex.resize(index + 1, nullptr);
+    }
+
+    protoIndex[index] = proto;
+}
+
 // 0x4A21DC
 static int _proto_new_id(int type)
 {
@@ -2184,6 +2195,9 @@ int _ResetPlayer()
     // SFALL: Fix base EMP DR not being properly initialized.
     proto->critter.data.baseStats[STAT_DAMAGE_RESISTANCE_EMP] = 100;
 
+    // CE: Base stats changed after reset above invalidated cache.
+    statsInvalidateCache();
+
     critterReset();
     characterEditorReset();
     protoCritterDataResetSkills(&(proto->critter.data));
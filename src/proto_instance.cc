@@ -116,6 +116,7 @@ int _obj_new_sid(Object* object, int* sidPtr)
     if (scriptType == SCRIPT_TYPE_SPATIAL) {
         script->sp.built_tile = builtTileCreate(object->tile, object->elevation);
         script->sp.radius = 3;
+        scriptsInvalidateSpatialIndex();
     }
 
     if (object->id == -1) {
@@ -151,6 +152,7 @@ int _obj_new_sid_inst(Object* obj, int scriptType, int scriptIndex)
     if (scriptType == SCRIPT_TYPE_SPATIAL) {
         script->sp.built_tile = builtTileCreate(obj->tile, obj->elevation);
         script->sp.radius = 3;
+        scriptsInvalidateSpatialIndex();
     }
 
     obj->sid = sid;
@@ -1631,6 +1633,8 @@ static int _check_door_state(Object* door, Object* obj2)
             door->flags &= ~OBJECT_OPEN_DOOR;
         }
 
+        combatInvalidateLineOfFireCache();
+        pathfinderInvalidateReachability();
         _obj_rebuild_all_light();
         tileWindowRefresh();
 
@@ -1669,6 +1673,8 @@ static int _check_door_state(Object* door, Object* obj2)
             door->flags |= OBJECT_OPEN_DOOR;
         }
 
+        combatInvalidateLineOfFireCache();
+        pathfinderInvalidateReachability();
         _obj_rebuild_all_light();
         tileWindowRefresh();
 
@@ -1983,6 +1989,7 @@ int objectLock(Object* object)
         break;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags |= OBJ_LOCKED;
+        pathfinderInvalidateReachability();
         break;
     default:
         return -1;
@@ -2004,6 +2011,7 @@ int objectUnlock(Object* object)
         return 0;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags &= ~OBJ_LOCKED;
+        pathfinderInvalidateReachability();
         return 0;
     }
 
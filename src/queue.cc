@@ -49,6 +49,9 @@ static QueueListNode* gLastFoundQueueListNode = nullptr;
 // 0x6648C0
 static QueueListNode* gQueueListHead;
 
+// CE: Storage for queue list nodes.
+static MemoryPool gQueueListNodePool = MEMORY_POOL_INITIALIZER("QueueListNode", QueueListNode, 128);
+
 // 0x51C540
 static EventTypeDescription gEventTypeDescriptions[EVENT_TYPE_COUNT] = {
     { drugEffectEventProcess, internal_free, drugEffectEventRead, drugEffectEventWrite, true, _item_d_clear },
@@ -77,6 +80,7 @@ void queueInit()
 int queueExit()
 {
     queueClear();
+    memoryPoolExit(&gQueueListNodePool);
     return 0;
 }
 
@@ -95,27 +99,27 @@ int queueLoad(File* stream)
 
     int rc = 0;
     for (int index = 0; index < count; index += 1) {
-        QueueListNode* queueListNode = (QueueListNode*)internal_malloc(sizeof(*queueListNode));
+        QueueListNode* queueListNode = (QueueListNode*)memoryPoolAlloc(&gQueueListNodePool);
         if (queueListNode == nullptr) {
             rc = -1;
             break;
         }
 
         if (fileReadUInt32(stream, &(queueListNode->time)) == -1) {
-            internal_free(queueListNode);
+            memoryPoolFree(&gQueueListNodePool, queueListNode);
             rc = -1;
             break;
         }
 
         if (fileReadInt32(stream, &(queueListNode->type)) == -1) {
-            internal_free(queueListNode);
+            memoryPoolFree(&gQueueListNodePool, queueListNode);
             rc = -1;
             break;
         }
 
         int objectId;
         if (fileReadInt32(stream, &objectId) == -1) {
-            internal_free(queueListNode);
+            memoryPoolFree(&gQueueListNodePool, queueListNode);
             rc = -1;
             break;
         }
@@ -139,7 +143,7 @@ int queueLoad(File* stream)
         EventTypeDescription* eventTypeDescription = &(gEventTypeDescriptions[queueListNode->type]);
         if (eventTypeDescription->readProc != nullptr) {
             if (eventTypeDescription->readProc(stream, &(queueListNode->data)) == -1) {
-                internal_free(queueListNode);
+                memoryPoolFree(&gQueueListNodePool, queueListNode);
                 rc = -1;
                 break;
             }
@@ -162,7 +166,7 @@ int queueLoad(File* stream)
                 eventTypeDescription->freeProc(gQueueListHead->data);
             }
 
-            internal_free(gQueueListHead);
+            memoryPoolFree(&gQueueListNodePool, gQueueListHead);
 
             gQueueListHead = next;
         }
@@ -237,7 +241,7 @@ int queueSave(File* stream)
 // 0x4A258C
 int queueAddEvent(int delay, Object* obj, void* data, int eventType)
 {
-    QueueListNode* newQueueListNode = (QueueListNode*)internal_malloc(sizeof(QueueListNode));
+    QueueListNode* newQueueListNode = (QueueListNode*)memoryPoolAlloc(&gQueueListNodePool);
     if (newQueueListNode == nullptr) {
         return -1;
     }
@@ -285,7 +289,7 @@ int queueRemoveEvents(Object* owner)
                 eventTypeDescription->freeProc(temp->data);
             }
 
-            internal_free(temp);
+            memoryPoolFree(&gQueueListNodePool, temp);
         } else {
             queueListNodePtr = &(queueListNode->next);
             queueListNode = queueListNode->next;
@@ -313,7 +317,7 @@ int queueRemoveEventsByType(Object* owner, int eventType)
                 eventTypeDescription->freeProc(temp->data);
             }
 
-            internal_free(temp);
+            memoryPoolFree(&gQueueListNodePool, temp);
         } else {
             queueListNodePtr = &(queueListNode->next);
             queueListNode = queueListNode->next;
@@ -362,7 +366,7 @@ int queueProcessEvents()
             eventTypeDescription->freeProc(queueListNode->data);
         }
 
-        internal_free(queueListNode);
+        memoryPoolFree(&gQueueListNodePool, queueListNode);
     }
 
     return stopProcess;
@@ -380,7 +384,7 @@ void queueClear()
             eventTypeDescription->freeProc(queueListNode->data);
         }
 
-        internal_free(queueListNode);
+        memoryPoolFree(&gQueueListNodePool, queueListNode);
 
         queueListNode = next;
     }
@@ -410,7 +414,7 @@ void _queue_clear_type(int eventType, QueueEventHandler* fn)
                     eventTypeDescription->freeProc(tmp->data);
                 }
 
-                internal_free(tmp);
+                memoryPoolFree(&gQueueListNodePool, tmp);
 
                 // SFALL: Re-read next event since `fn` handler can change it.
                 // This fixes crash when leaving the map while waiting for
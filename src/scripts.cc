@@ -5,6 +5,9 @@
 #include <string.h>
 #include <time.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "actions.h"
 #include "animation.h"
 #include "art.h"
@@ -83,6 +86,7 @@ static int scriptWrite(Script* scr, File* stream);
 static int scriptListExtentWrite(ScriptListExtent* a1, File* stream);
 static int scriptRead(Script* scr, File* stream);
 static int scriptListExtentRead(ScriptListExtent* a1, File* stream);
+static void scriptsBuildSpatialIndex();
 static int scriptGetNewId(int scriptType);
 static int scriptsRemoveLocalVars(Script* script);
 static int scriptsGetMessageList(int a1, MessageList** out_message_list);
@@ -110,6 +114,12 @@ static int gScriptsEnumerationElevation = 0;
 // 0x51C6BC
 static bool _scr_SpatialsEnabled = true;
 
+// CE: Spatial scripts (sids in script list order) which are triggered by
+// stepping on a given tile, one map per elevation. See
+// |scriptsBuildSpatialIndex|.
+static std::unordered_map<int, std::vector<int>> gScriptsSpatialIndex[ELEVATION_COUNT];
+static bool gScriptsSpatialIndexValid = false;
+
 // 0x51C6C0
 static ScriptList gScriptLists[SCRIPT_TYPE_COUNT];
 
@@ -1600,6 +1610,11 @@ int _scr_game_init()
     gameTimeSetTime(302400);
     tickersAdd(_doBkProcesses);
 
+    // CE: Time budget for background scripts per tick (in ms).
+    int updateBudget = 0;
+    configGetInt(&gSfallConfig, SFALL_CONFIG_MISC_KEY, SFALL_CONFIG_SCRIPT_UPDATE_BUDGET, &updateBudget);
+    interpreterSetUpdateBudget(updateBudget);
+
     if (scriptsSetDudeScript() == -1) {
         return -1;
     }
@@ -2031,6 +2046,8 @@ static int scriptListExtentRead(ScriptListExtent* scriptExtent, File* stream)
 // 0x4A5C50
 int scriptLoadAll(File* stream)
 {
+    scriptsInvalidateSpatialIndex();
+
     for (int index = 0; index < SCRIPT_TYPE_COUNT; index++) {
         ScriptList* scriptList = &(gScriptLists[index]);
 
@@ -2194,6 +2211,10 @@ int scriptAdd(int* sidPtr, int scriptType)
 
     *sidPtr = sid;
 
+    if (scriptType == SCRIPT_TYPE_SPATIAL) {
+        scriptsInvalidateSpatialIndex();
+    }
+
     Script* scr = &(scriptListExtent->scripts[scriptListExtent->length]);
     scr->sid = sid;
     scr->sp.built_tile = -1;
@@ -2300,6 +2321,10 @@ int scriptRemove(int sid)
         return -1;
     }
 
+    if (SID_TYPE(sid) == SCRIPT_TYPE_SPATIAL) {
+        scriptsInvalidateSpatialIndex();
+    }
+
     Script* script = &(scriptListExtent->scripts[index]);
     if ((script->flags & SCRIPT_FLAG_0x02) != 0) {
         if (script->program != nullptr) {
@@ -2431,6 +2456,8 @@ int _scr_remove_all_force()
         scriptList->length = 0;
     }
 
+    scriptsInvalidateSpatialIndex();
+
     gScriptsEnumerationScriptIndex = 0;
     gScriptsEnumerationScriptListExtent = nullptr;
     gScriptsEnumerationElevation = 0;
@@ -2542,30 +2569,123 @@ bool scriptsExecSpatialProc(Object* object, int tile, int elevation)
 
     int builtTile = builtTileCreate(tile, elevation);
 
-    for (Script* script = scriptGetFirstSpatialScript(elevation); script != nullptr; script = scriptGetNextSpatialScript()) {
-        if (builtTile == script->sp.built_tile) {
-            // NOTE: Uninline.
-            scriptSetObjects(script->sid, object, nullptr);
-        } else {
-            if (script->sp.radius == 0) {
+    // CE: Only visit scripts covering destination tile instead of every
+    // spatial script on the elevation.
+    if (!gScriptsSpatialIndexValid) {
+        scriptsBuildSpatialIndex();
+    }
+
+    if (elevationIsValid(elevation)) {
+        auto it = gScriptsSpatialIndex[elevation].find(tile);
+        if (it != gScriptsSpatialIndex[elevation].end()) {
+            // Procs can add or remove scripts, so iterate a copy and revalidate
+            // every script the same way original loop did.
+            std::vector<int> sids = it->second;
+            for (int sid : sids) {
+                Script* script;
+                if (scriptGetScript(sid, &script) == -1) {
+                    continue;
+                }
+
+                if ((script->flags & SCRIPT_FLAG_0x02) != 0 || builtTileGetElevation(script->sp.built_tile) != elevation) {
+                    continue;
+                }
+
+                if (builtTile == script->sp.built_tile) {
+                    // NOTE: Uninline.
+                    scriptSetObjects(script->sid, object, nullptr);
+                } else {
+                    if (script->sp.radius == 0) {
+                        continue;
+                    }
+
+                    int distance = tileDistanceBetween(builtTileGetTile(script->sp.built_tile), tile);
+                    if (distance > script->sp.radius) {
+                        continue;
+                    }
+
+                    // NOTE: Uninline.
+                    scriptSetObjects(script->sid, object, nullptr);
+                }
+
+                scriptExecProc(script->sid, SCRIPT_PROC_SPATIAL);
+            }
+        }
+    }
+
+    _scr_SpatialsEnabled = true;
+
+    return true;
+}
+
+// CE: Must be called whenever spatial script is added, removed or its tile or
+// radius is changed.
+void scriptsInvalidateSpatialIndex()
+{
+    gScriptsSpatialIndexValid = false;
+}
+
+// Buckets spatial scripts by every tile they are triggered from: the tile
+// they are built on and tiles within their radius. Disabled scripts are
+// indexed too, their flags are checked when triggered.
+static void scriptsBuildSpatialIndex()
+{
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        gScriptsSpatialIndex[elevation].clear();
+    }
+
+    ScriptListExtent* extent = gScriptLists[SCRIPT_TYPE_SPATIAL].head;
+    while (extent != nullptr) {
+        for (int index = 0; index < extent->length; index++) {
+            Script* script = &(extent->scripts[index]);
+            if (script->sp.built_tile == -1) {
                 continue;
             }
 
-            int distance = tileDistanceBetween(builtTileGetTile(script->sp.built_tile), tile);
-            if (distance > script->sp.radius) {
+            int elevation = builtTileGetElevation(script->sp.built_tile);
+            if (!elevationIsValid(elevation)) {
                 continue;
             }
 
-            // NOTE: Uninline.
-            scriptSetObjects(script->sid, object, nullptr);
-        }
+            int centerTile = builtTileGetTile(script->sp.built_tile);
+            auto& buckets = gScriptsSpatialIndex[elevation];
 
-        scriptExecProc(script->sid, SCRIPT_PROC_SPATIAL);
-    }
+            buckets[centerTile].push_back(script->sid);
 
-    _scr_SpatialsEnabled = true;
+            if (script->sp.radius <= 0) {
+                continue;
+            }
 
-    return true;
+            // Every step changes hex column and row by at most one, so tiles
+            // within radius are inside this box.
+            int radius = script->sp.radius;
+            int centerX = centerTile % HEX_GRID_WIDTH;
+            int centerY = centerTile / HEX_GRID_WIDTH;
+            for (int y = centerY - radius; y <= centerY + radius; y++) {
+                if (y < 0 || y >= HEX_GRID_HEIGHT) {
+                    continue;
+                }
+
+                for (int x = centerX - radius; x <= centerX + radius; x++) {
+                    if (x < 0 || x >= HEX_GRID_WIDTH) {
+                        continue;
+                    }
+
+                    int tile = y * HEX_GRID_WIDTH + x;
+                    if (tile == centerTile) {
+                        continue;
+                    }
+
+                    if (tileDistanceBetween(centerTile, tile) <= radius) {
+                        buckets[tile].push_back(script->sid);
+                    }
+                }
+            }
+        }
+        extent = extent->next;
+    }
+
+    gScriptsSpatialIndexValid = true;
 }
 
 // scr_load_all_scripts
@@ -217,6 +217,7 @@ Script* scriptGetNextSpatialScript();
 void _scr_spatials_enable();
 void _scr_spatials_disable();
 bool scriptsExecSpatialProc(Object* obj, int tile, int elevation);
+void scriptsInvalidateSpatialIndex();
 int scriptsExecStartProc();
 void scriptsExecMapEnterProc();
 void scriptsExecMapUpdateProc();
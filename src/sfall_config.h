@@ -86,6 +86,7 @@ namespace fallout {
 #define SFALL_CONFIG_WORLDMAP_TRAIL_MARKERS "WorldMapTravelMarkers"
 #define SFALL_CONFIG_SCREENSHOTS_FORMAT "ScreenshotsFormat" // note: this is F2CE feature - APAMk2
 #define SFALL_CONFIG_DISABLE_HORRIGAN "DisableHorrigan"
+#define SFALL_CONFIG_SCRIPT_UPDATE_BUDGET "ScriptUpdateBudget" // note: this is F2CE feature
 
 #define SFALL_CONFIG_BURST_MOD_DEFAULT_CENTER_MULTIPLIER 1
 #define SFALL_CONFIG_BURST_MOD_DEFAULT_CENTER_DIVISOR 3
@@ -3,9 +3,13 @@
 #include <algorithm>
 #include <cstdio> // for snprintf
 #include <cstring> // for strncpy, strlen
+#include <ctime> // for time_t
+#include <string>
+#include <unordered_map>
 
 #include "config.h"
 #include "debug.h"
+#include "input.h"
 #include "interpreter.h"
 #include "platform_compat.h"
 #include "sfall_arrays.h"
@@ -24,8 +28,45 @@ static constexpr const char* kSystemConfigFileNames[] = {
     "f2_res.ini",
 };
 
+/// Delay (in milliseconds) between the first pending write and writing changed
+/// .ini files to disk.
+static constexpr unsigned int kFlushDelay = 1000;
+
+/// Parsed .ini file.
+struct IniFile {
+    Config config;
+
+    /// Path used to read and write the file.
+    std::string path;
+
+    /// `true` if file exists on disk (or is about to be written).
+    bool exists;
+
+    /// Modification time and size of the file on disk at the moment it was
+    /// parsed. The file is parsed again when either of them changes.
+    time_t modificationTime;
+    long size;
+
+    /// `true` if `config` has changes which are not written to disk yet.
+    bool dirty;
+
+    /// `true` if the last attempt to write the file failed.
+    bool writeFailed;
+};
+
 static char basePath[COMPAT_MAX_PATH];
 
+/// Parsed .ini files keyed by resolved path, see `make_ini_file_key`.
+static std::unordered_map<std::string, IniFile*> iniFiles;
+
+static bool flushScheduled = false;
+static unsigned int firstPendingWriteTimestamp;
+
+static unsigned int cacheHits = 0;
+static unsigned int cacheParses = 0;
+static unsigned int cacheReparses = 0;
+static unsigned int cacheWrites = 0;
+
 /// Parses "fileName|section|key" triplet into parts. `fileName` and `section`
 /// chunks are copied into appropriate variables. Returns the pointer to `key`,
 /// or `nullptr` on any error.
@@ -72,36 +113,121 @@ static bool is_system_file_name(const char* fileName)
     return false;
 }
 
-// Loads an INI file specified by 'ini_file_name' (e.g., "myconfig.ini" or "ddraw.ini")
-// into the provided 'config_out' object.
-// The 'config_out' object must be initialized by the caller (using configInit).
-// The caller is also responsible for freeing 'config_out' (using configFree).
-// Returns true if the file was successfully found and read, false otherwise.
-static bool sfall_load_named_ini_file(const char* ini_file_name, Config* config_out)
+/// Builds cache key for .ini file at `path`. The path is resolved the same way
+/// file functions do and lowercased, so that separator and case variants of
+/// the same file share a single entry.
+static std::string make_ini_file_key(const char* path)
 {
-    if (ini_file_name == nullptr || config_out == nullptr) {
+    char key[COMPAT_MAX_PATH];
+    strncpy(key, path, sizeof(key) - 1);
+    key[sizeof(key) - 1] = '\0';
+    compat_windows_path_to_native(key);
+    compat_resolve_path(key);
+    compat_strlwr(key);
+    return key;
+}
+
+/// Writes pending changes of `iniFile` to disk. Returns `false` on error.
+static bool sfall_ini_write(IniFile* iniFile)
+{
+    const char* path = iniFile->path.c_str();
+
+    iniFile->dirty = false;
+
+    if (!configWrite(&(iniFile->config), path, false)) {
+        debugPrint("sfall_ini_write: unable to write '%s'\n", path);
+        iniFile->writeFailed = true;
         return false;
     }
 
+    iniFile->writeFailed = false;
+    cacheWrites++;
+
+    // Remember our own write so the file is not parsed again.
+    if (compat_stat(path, &(iniFile->modificationTime), &(iniFile->size)) != 0) {
+        iniFile->exists = false;
+    }
+
+    return true;
+}
+
+/// Resolves path to .ini file specified by `fileName` (e.g., "myconfig.ini" or
+/// "ddraw.ini"), and returns its parsed contents. The file is parsed on the
+/// first access and then again only when it's changed on disk. Files which do
+/// not exist are cached as empty configs. Returns `nullptr` on any error.
+static IniFile* sfall_ini_open(const char* fileName)
+{
+    if (fileName == nullptr) {
+        return nullptr;
+    }
+
     char path[COMPAT_MAX_PATH];
-    bool loaded = false;
+    time_t modificationTime = 0;
+    long size = 0;
+    bool exists = false;
 
-    if (basePath[0] != '\0' && !is_system_file_name(ini_file_name)) {
-        // Attempt to load requested file in base directory.
-        snprintf(path, sizeof(path), "%s\\%s", basePath, ini_file_name);
-        loaded = configRead(config_out, path, false);
+    if (basePath[0] != '\0' && !is_system_file_name(fileName)) {
+        // Attempt to find requested file in base directory.
+        snprintf(path, sizeof(path), "%s\\%s", basePath, fileName);
+        exists = compat_stat(path, &modificationTime, &size) == 0;
     }
 
-    if (!loaded) {
+    if (!exists) {
         // There was no base path set, requested file is a system config, or
-        // non-system config file was not found the base path - attempt to load
-        // from current working directory.
-        strncpy(path, ini_file_name, sizeof(path) - 1);
+        // non-system config file was not found the base path - attempt to find
+        // it in current working directory.
+        strncpy(path, fileName, sizeof(path) - 1);
         path[sizeof(path) - 1] = '\0';
-        loaded = configRead(config_out, path, false);
+        exists = compat_stat(path, &modificationTime, &size) == 0;
+    }
+
+    std::string key = make_ini_file_key(path);
+
+    IniFile* iniFile;
+    auto it = iniFiles.find(key);
+    if (it != iniFiles.end()) {
+        iniFile = it->second;
+
+        // Pending changes take precedence over whatever is on disk, they will
+        // overwrite it anyway.
+        if (iniFile->dirty
+            || (iniFile->exists == exists
+                && iniFile->modificationTime == modificationTime
+                && iniFile->size == size)) {
+            cacheHits++;
+            return iniFile;
+        }
+
+        configFree(&(iniFile->config));
+        cacheReparses++;
+    } else {
+        iniFile = new IniFile();
+        iniFiles[key] = iniFile;
+        cacheParses++;
+    }
+
+    if (!configInit(&(iniFile->config))) {
+        iniFiles.erase(key);
+        delete iniFile;
+        return nullptr;
     }
 
-    return loaded;
+    iniFile->path = path;
+
+    iniFile->exists = exists && configRead(&(iniFile->config), path, false);
+    iniFile->modificationTime = modificationTime;
+    iniFile->size = size;
+    iniFile->dirty = false;
+    iniFile->writeFailed = false;
+
+    return iniFile;
+}
+
+static void sfall_ini_flush_ticker()
+{
+    if (getTicksSince(firstPendingWriteTimestamp) >= kFlushDelay) {
+        sfall_ini_flush();
+    }
 }
 
 void sfall_ini_set_base_path(const char* path)
@@ -142,27 +268,23 @@ bool sfall_ini_get_string(const char* triplet, char* value, size_t size)
         return false;
     }
 
-    Config config;
-    if (!configInit(&config)) {
+    IniFile* iniFile = sfall_ini_open(fileName);
+    if (iniFile == nullptr) {
         return false;
     }
 
-    bool loaded = sfall_load_named_ini_file(fileName, &config);
-
     // NOTE: Sfall's `GetIniSetting` returns error code (-1) only when it cannot
     // parse triplet. Otherwise the default for string settings is empty string.
     value[0] = '\0';
 
-    if (loaded) {
+    if (iniFile->exists) {
         char* stringValue;
-        if (configGetString(&config, section, key, &stringValue)) {
+        if (configGetString(&(iniFile->config), section, key, &stringValue)) {
             strncpy(value, stringValue, size - 1);
             value[size - 1] = '\0';
         }
     }
 
-    configFree(&config);
-
     return true;
 }
 
@@ -184,35 +306,67 @@ bool sfall_ini_set_string(const char* triplet, const char* value)
         return false;
     }
 
-    Config config;
-    if (!configInit(&config)) {
+    IniFile* iniFile = sfall_ini_open(fileName);
+    if (iniFile == nullptr) {
         return false;
     }
 
-    char path[COMPAT_MAX_PATH];
-    bool loaded = false;
+    if (!configSetString(&(iniFile->config), section, key, value)) {
+        return false;
+    }
 
-    if (basePath[0] != '\0' && !is_system_file_name(fileName)) {
-        // Attempt to load requested file in base directory.
-        snprintf(path, sizeof(path), "%s\\%s", basePath, fileName);
-        loaded = configRead(&config, path, false);
+    iniFile->exists = true;
+    iniFile->dirty = true;
+
+    // Previous write of this file failed, there is little point in deferring
+    // this one - write it now so the script gets the actual result.
+    if (iniFile->writeFailed) {
+        return sfall_ini_write(iniFile);
     }
 
-    if (!loaded) {
-        // There was no base path set, requested file is a system config, or
-        // non-system config file was not found the base path - attempt to load
-        // from current working directory.
-        strcpy(path, fileName);
-        loaded = configRead(&config, path, false);
+    // Scripts tend to write several keys in a row (or the same key on every
+    // update), coalesce them into a single write.
+    if (!flushScheduled) {
+        flushScheduled = true;
+        firstPendingWriteTimestamp = getTicks();
+        tickersAdd(sfall_ini_flush_ticker);
     }
 
-    configSetString(&config, section, key, value);
+    return true;
+}
 
-    bool saved = configWrite(&config, path, false);
+void sfall_ini_flush()
+{
+    if (!flushScheduled) {
+        return;
+    }
 
-    configFree(&config);
+    flushScheduled = false;
+    tickersRemove(sfall_ini_flush_ticker);
 
-    return saved;
+    for (auto& pair : iniFiles) {
+        IniFile* iniFile = pair.second;
+        if (iniFile->dirty) {
+            sfall_ini_write(iniFile);
+        }
+    }
+}
+
+void sfall_ini_exit()
+{
+    sfall_ini_flush();
+
+    debugPrint("sfall_ini: %u hits, %u parses, %u reparses, %u writes\n",
+        cacheHits,
+        cacheParses,
+        cacheReparses,
+        cacheWrites);
+
+    for (auto& pair : iniFiles) {
+        configFree(&(pair.second->config));
+        delete pair.second;
+    }
+    iniFiles.clear();
 }
 
 static const ConfigSection* sfall_find_section_in_config(Config* config, const char* section_name)
@@ -270,15 +424,15 @@ void mf_get_ini_section(Program* program, int args)
         return;
     }
 
-    Config iniConfig;
-    if (!configInit(&iniConfig)) {
+    IniFile* iniFile = sfall_ini_open(filePath);
+    if (iniFile == nullptr) {
         debugPrint("mf_get_ini_section: Failed to initialize Config structure.");
         programStackPushInteger(program, arrayId);
         return;
     }
 
-    if (sfall_load_named_ini_file(filePath, &iniConfig)) {
-        const ConfigSection* section = sfall_find_section_in_config(&iniConfig, sectionName);
+    if (iniFile->exists) {
+        const ConfigSection* section = sfall_find_section_in_config(&(iniFile->config), sectionName);
 
         if (section != nullptr) {
             for (int i = 0; i < section->entriesLength; ++i) {
@@ -293,8 +447,6 @@ void mf_get_ini_section(Program* program, int args)
         }
     }
 
-    configFree(&iniConfig);
-
     programStackPushInteger(program, arrayId);
 }
 
@@ -310,15 +462,17 @@ void mf_get_ini_sections(Program* program, int args)
         return;
     }
 
-    Config iniConfig;
-    if (!configInit(&iniConfig)) {
+    IniFile* iniFile = sfall_ini_open(filePath);
+    if (iniFile == nullptr) {
         debugPrint("mf_get_ini_sections: Failed to initialize Config structure.");
         programStackPushInteger(program, arrayId);
         return;
     }
 
+    Config& iniConfig = iniFile->config;
+
     // note: seems to load sections in random order
-    if (sfall_load_named_ini_file(filePath, &iniConfig)) {
+    if (iniFile->exists) {
         if (iniConfig.entriesLength > 0) {
             arrayId = CreateTempArray(iniConfig.entriesLength, 0);
             for (int i = 0; i < iniConfig.entriesLength; ++i) {
@@ -332,8 +486,6 @@ void mf_get_ini_sections(Program* program, int args)
         }
     }
 
-    configFree(&iniConfig);
-
     if (arrayId == -1) {
         arrayId = CreateTempArray(0, 0);
     }
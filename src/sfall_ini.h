@@ -20,9 +20,19 @@ bool sfall_ini_get_string(const char* triplet, char* value, size_t size);
 /// Writes integer key identified by "fileName|section|key" triplet.
 bool sfall_ini_set_int(const char* triplet, int value);
 
-/// Writes string key identified by "fileName|section|key" triplet.
+/// Writes string key identified by "fileName|section|key" triplet. Changes are
+/// kept in memory and written to disk a bit later, see `sfall_ini_flush`, so
+/// `true` means the change is accepted, not that it's on disk. A failed write
+/// is logged, and every following write to the same file is performed
+/// immediately, returning `false` until the file can be written again.
 bool sfall_ini_set_string(const char* triplet, const char* value);
 
+/// Writes all pending changes to disk.
+void sfall_ini_flush();
+
+/// Writes all pending changes to disk and frees parsed .ini files.
+void sfall_ini_exit();
+
 // metarule and opcode implementations
 void mf_set_ini_setting(Program* program, int args);
 void mf_get_ini_section(Program* program, int args);
@@ -551,6 +551,9 @@ static void op_set_weapon_ammo_pid(Program* program)
             switch (itemGetType(obj)) {
             case ITEM_TYPE_WEAPON:
                 obj->data.item.weapon.ammoTypePid = ammoTypePid;
+
+                // CE: Loaded ammo weight depends on ammo pid.
+                itemInvalidateInventory(obj->owner);
                 break;
             }
         }
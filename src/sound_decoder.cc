@@ -11,12 +11,32 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOUND_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace fallout {
 
 #define SOUND_DECODER_IN_BUFFER_SIZE (512)
 
 typedef int (*ReadBandFunc)(SoundDecoder* soundDecoder, int offset, int bits);
 
+// CE: Entry of the lookup table for prefix coded band formats (17-27). Tables
+// are indexed with the next few bits of input and replace bit-by-bit branching
+// of the original handlers.
+typedef struct SoundDecoderBandCode {
+    // Length of the code in bits.
+    unsigned char bits;
+
+    // Number of zero samples encoded by this code, or 0 if it encodes single
+    // non-zero value.
+    unsigned char zeros;
+
+    // Index in the scale table relative to `scale0`.
+    signed char value;
+} SoundDecoderBandCode;
+
 static bool soundDecoderPrepare(SoundDecoder* soundDecoder, SoundDecoderReadProc* readProc, void* data);
 static unsigned char soundDecoderReadNextChunk(SoundDecoder* soundDecoder);
 static void init_pack_tables();
@@ -43,9 +63,11 @@ static bool soundDecoderFill(SoundDecoder* soundDecoder);
 static inline void soundDecoderRequireBits(SoundDecoder* soundDecoder, int bits);
 static inline void soundDecoderDropBits(SoundDecoder* soundDecoder, int bits);
 static int ReadBand_Fmt31(SoundDecoder* soundDecoder, int offset, int bits);
-
-// 0x51E328
-static int gSoundDecodersCount = 0;
+static void init_band_code(SoundDecoderBandCode* code, int bits, int zeros, int value);
+static void init_band_codes();
+static void untransform_columns(int* samples, int stride, int quads, int* state, int count);
+static void untransform_columns16(int* samples, int stride, int quads, short* state, int count);
+static int ReadBand_Codes(SoundDecoder* soundDecoder, int offset, const SoundDecoderBandCode* codes, int bits);
 
 // 0x51E330
 static ReadBandFunc _ReadBand_tbl[32] = {
@@ -92,11 +114,14 @@ static unsigned char pack3_3[32];
 // 0x6ADA00
 static unsigned short pack5_3[128];
 
-// 0x6ADB00
-static unsigned char* _AudioDecoder_scale0;
-
-// 0x6ADB04
-static unsigned char* _AudioDecoder_scale_tbl;
+static SoundDecoderBandCode gBandCodes17[1 << 3];
+static SoundDecoderBandCode gBandCodes18[1 << 2];
+static SoundDecoderBandCode gBandCodes20[1 << 4];
+static SoundDecoderBandCode gBandCodes21[1 << 3];
+static SoundDecoderBandCode gBandCodes23[1 << 5];
+static SoundDecoderBandCode gBandCodes24[1 << 4];
+static SoundDecoderBandCode gBandCodes26[1 << 5];
+static SoundDecoderBandCode gBandCodes27[1 << 4];
 
 // 0x4D3BB0
 static bool soundDecoderPrepare(SoundDecoder* soundDecoder, SoundDecoderReadProc* readProc, void* data)
@@ -165,6 +190,8 @@ static void init_pack_tables()
         }
     }
 
+    init_band_codes();
+
     inited = true;
 }
 
@@ -196,7 +223,7 @@ static int ReadBand_Fmt3_16(SoundDecoder* soundDecoder, int offset, int bits)
     int value;
     int v14;
 
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base += (int)(UINT_MAX << (bits - 1));
 
     int* p = (int*)soundDecoder->samples;
@@ -222,99 +249,19 @@ static int ReadBand_Fmt3_16(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D3E90
 static int ReadBand_Fmt17(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 3);
-
-        int value = soundDecoder->hold & 0xFF;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x02)) {
-            soundDecoderDropBits(soundDecoder, 2);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 3);
-
-            if (value & 0x04) {
-                *p = base[1];
-            } else {
-                *p = base[-1];
-            }
-
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes17, 3);
 }
 
 // 0x4D3F98
 static int ReadBand_Fmt18(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 2);
-
-        int value = soundDecoder->hold;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                return 1;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 2);
-
-            if (value & 0x02) {
-                *p = base[1];
-            } else {
-                *p = base[-1];
-            }
-
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes18, 2);
 }
 
 // 0x4D4068
 static int ReadBand_Fmt19(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base -= 1;
 
     int* p = (int*)soundDecoder->samples;
@@ -352,117 +299,19 @@ static int ReadBand_Fmt19(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4158
 static int ReadBand_Fmt20(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 4);
-
-        int value = soundDecoder->hold & 0xFF;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x02)) {
-            soundDecoderDropBits(soundDecoder, 2);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 4);
-
-            if (value & 0x08) {
-                if (value & 0x04) {
-                    *p = base[2];
-                } else {
-                    *p = base[1];
-                }
-            } else {
-                if (value & 0x04) {
-                    *p = base[-1];
-                } else {
-                    *p = base[-2];
-                }
-            }
-
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes20, 4);
 }
 
 // 0x4D4254
 static int ReadBand_Fmt21(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 3);
-
-        int value = soundDecoder->hold & 0xFF;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 3);
-
-            if (value & 0x04) {
-                if (value & 0x02) {
-                    *p = base[2];
-                } else {
-                    *p = base[1];
-                }
-            } else {
-                if (value & 0x02) {
-                    *p = base[-1];
-                } else {
-                    *p = base[-2];
-                }
-            }
-
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes21, 3);
 }
 
 // 0x4D4338
 static int ReadBand_Fmt22(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
     base -= 2;
 
     int* p = (int*)soundDecoder->samples;
@@ -504,226 +353,31 @@ static int ReadBand_Fmt22(SoundDecoder* soundDecoder, int offset, int bits)
 // 0x4D4434
 static int ReadBand_Fmt23(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 5);
-
-        int value = soundDecoder->hold;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x02)) {
-            soundDecoderDropBits(soundDecoder, 2);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x04)) {
-            soundDecoderDropBits(soundDecoder, 4);
-
-            if (value & 0x08) {
-                *p = base[1];
-            } else {
-                *p = base[-1];
-            }
-
-            p += soundDecoder->subbands;
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 5);
-
-            value >>= 3;
-            value &= 0x03;
-            if (value >= 2) {
-                value += 3;
-            }
-
-            *p = base[value - 3];
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes23, 5);
 }
 
 // 0x4D4584
 static int ReadBand_Fmt24(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 4);
-
-        int value = soundDecoder->hold & 0xFF;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x02)) {
-            soundDecoderDropBits(soundDecoder, 3);
-
-            if (value & 0x04) {
-                *p = base[1];
-            } else {
-                *p = base[-1];
-            }
-
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 4);
-
-            value >>= 2;
-            value &= 0x03;
-            if (value >= 2) {
-                value += 3;
-            }
-
-            *p = base[value - 3];
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes24, 4);
 }
 
 // 0x4D4698
 static int ReadBand_Fmt26(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 5);
-
-        int value = soundDecoder->hold;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else if (!(value & 0x02)) {
-            soundDecoderDropBits(soundDecoder, 2);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 5);
-
-            value >>= 2;
-            value &= 0x07;
-            if (value >= 4) {
-                value += 1;
-            }
-
-            *p = base[value - 4];
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes26, 5);
 }
 
 // 0x4D47A4
 static int ReadBand_Fmt27(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
-
-    int* p = (int*)soundDecoder->samples;
-    p += offset;
-
-    int i = soundDecoder->samples_per_subband;
-    while (i != 0) {
-        soundDecoderRequireBits(soundDecoder, 4);
-
-        int value = soundDecoder->hold;
-        if (!(value & 0x01)) {
-            soundDecoderDropBits(soundDecoder, 1);
-
-            *p = 0;
-            p += soundDecoder->subbands;
-
-            if (--i == 0) {
-                break;
-            }
-        } else {
-            soundDecoderDropBits(soundDecoder, 4);
-
-            value >>= 1;
-            value &= 0x07;
-            if (value >= 4) {
-                value += 1;
-            }
-
-            *p = base[value - 4];
-            p += soundDecoder->subbands;
-            i--;
-        }
-    }
-
-    return 1;
+    return ReadBand_Codes(soundDecoder, offset, gBandCodes27, 4);
 }
 
 // 0x4D4870
 static int ReadBand_Fmt29(SoundDecoder* soundDecoder, int offset, int bits)
 {
-    short* base = (short*)_AudioDecoder_scale0;
+    short* base = (short*)soundDecoder->scale0;
 
     int* p = (int*)soundDecoder->samples;
     p += offset;
@@ -773,7 +427,7 @@ static bool ReadBands(SoundDecoder* soundDecoder)
 
     v17 = 1 << v9;
 
-    v18 = (unsigned short*)_AudioDecoder_scale0;
+    v18 = (unsigned short*)soundDecoder->scale0;
     v19 = v17;
     v21 = 0;
     while (v19--) {
@@ -781,7 +435,7 @@ static bool ReadBands(SoundDecoder* soundDecoder)
         v21 += v15;
     }
 
-    v18 = (unsigned short*)_AudioDecoder_scale0;
+    v18 = (unsigned short*)soundDecoder->scale0;
     v19 = v17;
     v21 = -v15;
     while (v19--) {
@@ -790,8 +444,6 @@ static bool ReadBands(SoundDecoder* soundDecoder)
         v21 -= v15;
     }
 
-    init_pack_tables();
-
     for (int index = 0; index < soundDecoder->subbands; index++) {
         soundDecoderRequireBits(soundDecoder, 5);
         int bits = soundDecoder->hold & 0x1F;
@@ -860,64 +512,21 @@ static void untransform_subband0(unsigned char* a1, unsigned char* a2, int a3, i
             v31--;
         }
     } else {
-        int v30 = a4 >> 1;
-        int v32 = a3;
-        while (v32 != 0) {
-            int* v19 = (int*)a2;
-
-            int v20;
-            int v22;
-            if (v30 & 0x01) {
-
-            } else {
-                v20 = (int)*(short*)a1;
-                v22 = *(int*)a1 >> 16;
-            }
-
-            int v23 = v30 >> 1;
-            while (--v23 != -1) {
-                int v24 = *v19;
-                *v19 += 2 * v22 + v20;
-                v19 += a3;
-
-                int v26 = *v19;
-                *v19 = 2 * v24 - v22 - v26;
-                v19 += a3;
-
-                v20 = *v19;
-                *v19 += 2 * v26 + v24;
-                v19 += a3;
-
-                v22 = *v19;
-                *v19 = 2 * v20 - v26 - v22;
-                v19 += a3;
-            }
-
-            *(short*)a1 = v20 & 0xFFFF;
-            *(short*)(a1 + 2) = v22 & 0xFFFF;
-
-            a1 += 4;
-            a2 += 4;
-            v32--;
-        }
+        // CE: Process subbands in groups of adjacent columns instead of one
+        // column at a time. See `untransform_columns16`.
+        //
+        // NOTE: Original code leaves carried values uninitialized when
+        // `a4 / 2` is odd. Block sizes are always even in practice, so this
+        // case is treated the same way.
+        untransform_columns16((int*)a2, a3, a4 >> 2, (short*)a1, a3);
     }
 }
 
 // 0x4D4D1C
 static void untransform_subband(unsigned char* a1, unsigned char* a2, int a3, int a4)
 {
-    int v13;
-    int* v14;
     int* v25;
     int* v26;
-    int v15;
-    int v16;
-    int v17;
-
-    int* v18;
-    int v19;
-    int* v20;
-    int* v21;
 
     v26 = (int*)a1;
     v25 = (int*)a2;
@@ -956,41 +565,9 @@ static void untransform_subband(unsigned char* a1, unsigned char* a2, int a3, in
             v25 += 1;
         }
     } else {
-        int v24 = a3;
-
-        while (v24 != 0) {
-            v13 = a4 >> 2;
-            v14 = v25;
-            v15 = v26[0];
-            v16 = v26[1];
-
-            while (--v13 != -1) {
-                v17 = *v14;
-                *v14 += 2 * v16 + v15;
-
-                v18 = v14 + a3;
-                v19 = *v18;
-                *v18 = 2 * v17 - v16 - v19;
-
-                v20 = v18 + a3;
-                v15 = *v20;
-                *v20 += 2 * v19 + v17;
-
-                v21 = v20 + a3;
-                v16 = *v21;
-                *v21 = 2 * v15 - v19 - v16;
-
-                v14 = v21 + a3;
-            }
-
-            v26[0] = v15;
-            v26[1] = v16;
-
-            v26 += 2;
-            v25 += 1;
-
-            v24--;
-        }
+        // CE: Process subbands in groups of adjacent columns instead of one
+        // column at a time. See `untransform_columns`.
+        untransform_columns(v25, a3, a4 >> 2, v26, a3);
     }
 }
 
@@ -1125,16 +702,11 @@ void soundDecoderFree(SoundDecoder* soundDecoder)
         free(soundDecoder->samples);
     }
 
-    free(soundDecoder);
-
-    gSoundDecodersCount--;
-
-    if (gSoundDecodersCount == 0) {
-        if (_AudioDecoder_scale_tbl != nullptr) {
-            free(_AudioDecoder_scale_tbl);
-            _AudioDecoder_scale_tbl = nullptr;
-        }
+    if (soundDecoder->scale_tbl != nullptr) {
+        free(soundDecoder->scale_tbl);
     }
+
+    free(soundDecoder);
 }
 
 // 0x4D50A8
@@ -1151,7 +723,9 @@ SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int*
 
     memset(soundDecoder, 0, sizeof(*soundDecoder));
 
-    gSoundDecodersCount++;
+    // CE: Pack tables are static and shared, make sure they are built before
+    // any decoding takes place (possibly on the worker thread).
+    init_pack_tables();
 
     if (!soundDecoderPrepare(soundDecoder, readProc, data)) {
         goto L66;
@@ -1169,7 +743,7 @@ SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int*
     }
 
     soundDecoderRequireBits(soundDecoder, 8);
-    v20 = soundDecoder->hold;
+    v20 = soundDecoder->hold & 0xFF;
     soundDecoderDropBits(soundDecoder, 8);
 
     if (v20 != 1) {
@@ -1231,11 +805,13 @@ SoundDecoder* soundDecoderInit(SoundDecoderReadProc* readProc, void* data, int*
 
     soundDecoder->samp_cnt = 0;
 
-    if (gSoundDecodersCount == 1) {
-        _AudioDecoder_scale_tbl = (unsigned char*)malloc(0x20000);
-        _AudioDecoder_scale0 = _AudioDecoder_scale_tbl + 0x10000;
+    soundDecoder->scale_tbl = (unsigned char*)malloc(0x20000);
+    if (soundDecoder->scale_tbl == nullptr) {
+        goto L66;
     }
 
+    soundDecoder->scale0 = soundDecoder->scale_tbl + 0x10000;
+
     *channelsPtr = soundDecoder->channels;
     *sampleRatePtr = soundDecoder->rate;
     *sampleCountPtr = soundDecoder->file_cnt;
@@ -1255,6 +831,26 @@ L66:
 
 static inline void soundDecoderRequireBits(SoundDecoder* soundDecoder, int bits)
 {
+    if (soundDecoder->bits >= bits) {
+        return;
+    }
+
+    // CE: Top up accumulator with as many whole bytes as it can hold, so most
+    // calls return immediately instead of fetching one byte at a time.
+    int count = (64 - soundDecoder->bits) >> 3;
+    if (soundDecoder->remainingInSize >= count) {
+        unsigned long long value = 0;
+        for (int index = 0; index < count; index++) {
+            value |= static_cast<unsigned long long>(soundDecoder->nextIn[index]) << (index * 8);
+        }
+
+        soundDecoder->hold |= value << soundDecoder->bits;
+        soundDecoder->bits += count * 8;
+        soundDecoder->nextIn += count;
+        soundDecoder->remainingInSize -= count;
+        return;
+    }
+
     while (soundDecoder->bits < bits) {
         soundDecoder->remainingInSize--;
 
@@ -1264,7 +860,7 @@ static inline void soundDecoderRequireBits(SoundDecoder* soundDecoder, int bits)
         } else {
             ch = *soundDecoder->nextIn++;
         }
-        soundDecoder->hold |= ch << soundDecoder->bits;
+        soundDecoder->hold |= static_cast<unsigned long long>(ch) << soundDecoder->bits;
         soundDecoder->bits += 8;
     }
 }
@@ -1293,4 +889,284 @@ static int ReadBand_Fmt31(SoundDecoder* soundDecoder, int offset, int bits)
     return 0;
 }
 
+static void init_band_code(SoundDecoderBandCode* code, int bits, int zeros, int value)
+{
+    code->bits = bits;
+    code->zeros = zeros;
+    code->value = value;
+}
+
+// Builds lookup tables for prefix coded formats. Each table entry mirrors the
+// branches taken by the original handler for that input.
+static void init_band_codes()
+{
+    int value;
+    int index;
+
+    for (value = 0; value < (1 << 3); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes17[value]), 1, 2, 0);
+        } else if (!(value & 0x02)) {
+            init_band_code(&(gBandCodes17[value]), 2, 1, 0);
+        } else {
+            init_band_code(&(gBandCodes17[value]), 3, 0, (value & 0x04) ? 1 : -1);
+        }
+    }
+
+    for (value = 0; value < (1 << 2); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes18[value]), 1, 1, 0);
+        } else {
+            init_band_code(&(gBandCodes18[value]), 2, 0, (value & 0x02) ? 1 : -1);
+        }
+    }
+
+    for (value = 0; value < (1 << 4); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes20[value]), 1, 2, 0);
+        } else if (!(value & 0x02)) {
+            init_band_code(&(gBandCodes20[value]), 2, 1, 0);
+        } else if (value & 0x08) {
+            init_band_code(&(gBandCodes20[value]), 4, 0, (value & 0x04) ? 2 : 1);
+        } else {
+            init_band_code(&(gBandCodes20[value]), 4, 0, (value & 0x04) ? -1 : -2);
+        }
+    }
+
+    for (value = 0; value < (1 << 3); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes21[value]), 1, 1, 0);
+        } else if (value & 0x04) {
+            init_band_code(&(gBandCodes21[value]), 3, 0, (value & 0x02) ? 2 : 1);
+        } else {
+            init_band_code(&(gBandCodes21[value]), 3, 0, (value & 0x02) ? -1 : -2);
+        }
+    }
+
+    for (value = 0; value < (1 << 5); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes23[value]), 1, 2, 0);
+        } else if (!(value & 0x02)) {
+            init_band_code(&(gBandCodes23[value]), 2, 1, 0);
+        } else if (!(value & 0x04)) {
+            init_band_code(&(gBandCodes23[value]), 4, 0, (value & 0x08) ? 1 : -1);
+        } else {
+            index = (value >> 3) & 0x03;
+            if (index >= 2) {
+                index += 3;
+            }
+            init_band_code(&(gBandCodes23[value]), 5, 0, index - 3);
+        }
+    }
+
+    for (value = 0; value < (1 << 4); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes24[value]), 1, 1, 0);
+        } else if (!(value & 0x02)) {
+            init_band_code(&(gBandCodes24[value]), 3, 0, (value & 0x04) ? 1 : -1);
+        } else {
+            index = (value >> 2) & 0x03;
+            if (index >= 2) {
+                index += 3;
+            }
+            init_band_code(&(gBandCodes24[value]), 4, 0, index - 3);
+        }
+    }
+
+    for (value = 0; value < (1 << 5); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes26[value]), 1, 2, 0);
+        } else if (!(value & 0x02)) {
+            init_band_code(&(gBandCodes26[value]), 2, 1, 0);
+        } else {
+            index = (value >> 2) & 0x07;
+            if (index >= 4) {
+                index += 1;
+            }
+            init_band_code(&(gBandCodes26[value]), 5, 0, index - 4);
+        }
+    }
+
+    for (value = 0; value < (1 << 4); value++) {
+        if (!(value & 0x01)) {
+            init_band_code(&(gBandCodes27[value]), 1, 1, 0);
+        } else {
+            index = (value >> 1) & 0x07;
+            if (index >= 4) {
+                index += 1;
+            }
+            init_band_code(&(gBandCodes27[value]), 4, 0, index - 4);
+        }
+    }
+}
+
+// Generic handler for prefix coded formats, [bits] is the length of the
+// longest code.
+static int ReadBand_Codes(SoundDecoder* soundDecoder, int offset, const SoundDecoderBandCode* codes, int bits)
+{
+    short* base = (short*)soundDecoder->scale0;
+
+    int* p = (int*)soundDecoder->samples;
+    p += offset;
+
+    int mask = (1 << bits) - 1;
+    int stride = soundDecoder->subbands;
+
+    int i = soundDecoder->samples_per_subband;
+    while (i != 0) {
+        soundDecoderRequireBits(soundDecoder, bits);
+
+        const SoundDecoderBandCode* code = &(codes[soundDecoder->hold & mask]);
+        soundDecoderDropBits(soundDecoder, code->bits);
+
+        if (code->zeros == 0) {
+            *p = base[code->value];
+            p += stride;
+            i--;
+            continue;
+        }
+
+        *p = 0;
+        p += stride;
+
+        if (--i == 0) {
+            break;
+        }
+
+        if (code->zeros == 2) {
+            *p = 0;
+            p += stride;
+            i--;
+        }
+    }
+
+    return 1;
+}
+
+// Applies lifting filter to [count] adjacent columns of [samples], [quads]
+// groups of four rows each. [state] holds two carried values per column
+// (interleaved), they are updated to the last two rows on return.
+//
+// Columns are independent, so this is the same as running the original
+// per-column loop for each of them, but rows are walked in memory order and
+// several columns are computed at once.
+static void untransform_columns(int* samples, int stride, int quads, int* state, int count)
+{
+    int column = 0;
+
+#ifdef SOUND_DECODER_SSE2
+    for (; column + 4 <= count; column += 4) {
+        __m128i lo = _mm_loadu_si128((__m128i*)(state + column * 2));
+        __m128i hi = _mm_loadu_si128((__m128i*)(state + column * 2 + 4));
+        __m128i s0 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i s1 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+
+        int* p = samples + column;
+        for (int quad = 0; quad < quads; quad++) {
+            __m128i r0 = _mm_loadu_si128((__m128i*)p);
+            __m128i r1 = _mm_loadu_si128((__m128i*)(p + stride));
+            __m128i r2 = _mm_loadu_si128((__m128i*)(p + stride * 2));
+            __m128i r3 = _mm_loadu_si128((__m128i*)(p + stride * 3));
+
+            _mm_storeu_si128((__m128i*)p, _mm_add_epi32(_mm_add_epi32(r0, s0), _mm_add_epi32(s1, s1)));
+            _mm_storeu_si128((__m128i*)(p + stride), _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(r0, r0), s1), r1));
+            _mm_storeu_si128((__m128i*)(p + stride * 2), _mm_add_epi32(_mm_add_epi32(r2, r0), _mm_add_epi32(r1, r1)));
+            _mm_storeu_si128((__m128i*)(p + stride * 3), _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(r2, r2), r1), r3));
+
+            s0 = r2;
+            s1 = r3;
+            p += stride * 4;
+        }
+
+        _mm_storeu_si128((__m128i*)(state + column * 2), _mm_unpacklo_epi32(s0, s1));
+        _mm_storeu_si128((__m128i*)(state + column * 2 + 4), _mm_unpackhi_epi32(s0, s1));
+    }
+#endif
+
+    for (; column < count; column++) {
+        int s0 = state[column * 2];
+        int s1 = state[column * 2 + 1];
+
+        int* p = samples + column;
+        for (int quad = 0; quad < quads; quad++) {
+            int r0 = p[0];
+            int r1 = p[stride];
+            int r2 = p[stride * 2];
+            int r3 = p[stride * 3];
+
+            p[0] = r0 + 2 * s1 + s0;
+            p[stride] = 2 * r0 - s1 - r1;
+            p[stride * 2] = r2 + 2 * r1 + r0;
+            p[stride * 3] = 2 * r2 - r1 - r3;
+
+            s0 = r2;
+            s1 = r3;
+            p += stride * 4;
+        }
+
+        state[column * 2] = s0;
+        state[column * 2 + 1] = s1;
+    }
+}
+
+// Same as `untransform_columns`, but carried values are stored as 16-bit
+// pairs (used by the first level).
+static void untransform_columns16(int* samples, int stride, int quads, short* state, int count)
+{
+    int column = 0;
+
+#ifdef SOUND_DECODER_SSE2
+    for (; column + 4 <= count; column += 4) {
+        __m128i pairs = _mm_loadu_si128((__m128i*)(state + column * 2));
+        __m128i s0 = _mm_srai_epi32(_mm_slli_epi32(pairs, 16), 16);
+        __m128i s1 = _mm_srai_epi32(pairs, 16);
+
+        int* p = samples + column;
+        for (int quad = 0; quad < quads; quad++) {
+            __m128i r0 = _mm_loadu_si128((__m128i*)p);
+            __m128i r1 = _mm_loadu_si128((__m128i*)(p + stride));
+            __m128i r2 = _mm_loadu_si128((__m128i*)(p + stride * 2));
+            __m128i r3 = _mm_loadu_si128((__m128i*)(p + stride * 3));
+
+            _mm_storeu_si128((__m128i*)p, _mm_add_epi32(_mm_add_epi32(r0, s0), _mm_add_epi32(s1, s1)));
+            _mm_storeu_si128((__m128i*)(p + stride), _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(r0, r0), s1), r1));
+            _mm_storeu_si128((__m128i*)(p + stride * 2), _mm_add_epi32(_mm_add_epi32(r2, r0), _mm_add_epi32(r1, r1)));
+            _mm_storeu_si128((__m128i*)(p + stride * 3), _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(r2, r2), r1), r3));
+
+            s0 = r2;
+            s1 = r3;
+            p += stride * 4;
+        }
+
+        pairs = _mm_or_si128(_mm_and_si128(s0, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(s1, 16));
+        _mm_storeu_si128((__m128i*)(state + column * 2), pairs);
+    }
+#endif
+
+    for (; column < count; column++) {
+        int s0 = state[column * 2];
+        int s1 = state[column * 2 + 1];
+
+        int* p = samples + column;
+        for (int quad = 0; quad < quads; quad++) {
+            int r0 = p[0];
+            int r1 = p[stride];
+            int r2 = p[stride * 2];
+            int r3 = p[stride * 3];
+
+            p[0] = r0 + 2 * s1 + s0;
+            p[stride] = 2 * r0 - s1 - r1;
+            p[stride * 2] = r2 + 2 * r1 + r0;
+            p[stride * 3] = 2 * r2 - r1 - r3;
+
+            s0 = r2;
+            s1 = r3;
+            p += stride * 4;
+        }
+
+        state[column * 2] = s0 & 0xFFFF;
+        state[column * 2 + 1] = s1 & 0xFFFF;
+    }
+}
+
 } // namespace fallout
@@ -20,7 +20,9 @@ typedef struct SoundDecoder {
     int remainingInSize;
 
     // Bit accumulator.
-    int hold;
+    //
+    // CE: Widened to 64 bits so it can be refilled several bytes at a time.
+    unsigned long long hold;
 
     // Number of bits in bit accumulator.
     int bits;
@@ -37,6 +39,11 @@ typedef struct SoundDecoder {
     int file_cnt;
     unsigned char* samp_ptr;
     int samp_cnt;
+
+    // CE: Dequantization table. In the original code it was shared between
+    // all decoders, which makes decoding on more than one thread impossible.
+    unsigned char* scale_tbl;
+    unsigned char* scale0;
 } SoundDecoder;
 
 size_t soundDecoderDecode(SoundDecoder* soundDecoder, void* buffer, size_t size);
@@ -0,0 +1,363 @@
+#include "sound_decoder_worker.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fallout {
+
+// Size of a single block of decoded PCM data in bytes.
+#define SOUND_DECODER_STREAM_BLOCK_SIZE (4096)
+
+#define SOUND_DECODER_STREAM_MIN_BLOCKS (4)
+#define SOUND_DECODER_STREAM_MAX_BLOCKS (64)
+
+#define SOUND_DECODER_WORKER_MAX_THREADS (2)
+
+typedef struct SoundDecoderStreamBlock {
+    unsigned char* data;
+    size_t size;
+} SoundDecoderStreamBlock;
+
+// Ring of decoded blocks for a single ACM stream.
+//
+// The ring is a single-producer/single-consumer queue. The consumer is the
+// stream reader (game thread), it only touches [tail] and [readOffset]. The
+// producer is either a worker thread, or the reader itself when nothing is
+// ready yet. Producers are serialized with [decodeMutex], which also protects
+// the decoder state.
+struct SoundDecoderStream {
+    SoundDecoder* soundDecoder;
+    SoundDecoderStreamBlock* blocks;
+
+    // Number of blocks in the ring, always power of two.
+    unsigned int blocksLength;
+
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    std::atomic<bool> eof;
+
+    // Offset of the next unread byte in the block at [tail].
+    size_t readOffset;
+
+    // Set once the first read completes, underruns during initial preload
+    // are expected and not reported.
+    bool primed;
+
+    std::mutex decodeMutex;
+
+    // Set while one of the workers is filling this stream, protected by
+    // [gSoundDecoderWorkerMutex].
+    bool busy;
+
+    unsigned int underruns;
+};
+
+static void soundDecoderWorkerProc();
+static SoundDecoderStream* soundDecoderWorkerFindStream();
+static void soundDecoderWorkerWakeUp();
+static bool soundDecoderStreamNeedsData(SoundDecoderStream* stream);
+static bool soundDecoderStreamProduce(SoundDecoderStream* stream);
+
+static std::mutex gSoundDecoderWorkerMutex;
+static std::condition_variable gSoundDecoderWorkerCondition;
+static std::condition_variable gSoundDecoderWorkerIdleCondition;
+static std::vector<std::thread> gSoundDecoderWorkerThreads;
+static std::vector<SoundDecoderStream*> gSoundDecoderWorkerStreams;
+static bool gSoundDecoderWorkerShouldStop = false;
+static bool gSoundDecoderWorkerRunning = false;
+
+static std::atomic<unsigned int> gSoundDecoderWorkerBlocksDecoded(0);
+static std::atomic<unsigned int> gSoundDecoderWorkerUnderruns(0);
+
+bool soundDecoderWorkerInit()
+{
+    if (gSoundDecoderWorkerRunning) {
+        return true;
+    }
+
+#if defined(__EMSCRIPTEN__)
+    // Web build is compiled without threads support, streams are decoded
+    // synchronously on read.
+    return false;
+#else
+    unsigned int threads = std::thread::hardware_concurrency();
+    if (threads > 1) {
+        threads -= 1;
+    } else {
+        threads = 1;
+    }
+
+    threads = std::min(threads, static_cast<unsigned int>(SOUND_DECODER_WORKER_MAX_THREADS));
+
+    gSoundDecoderWorkerShouldStop = false;
+
+    for (unsigned int index = 0; index < threads; index++) {
+        gSoundDecoderWorkerThreads.emplace_back(soundDecoderWorkerProc);
+    }
+
+    gSoundDecoderWorkerRunning = true;
+
+    return true;
+#endif
+}
+
+void soundDecoderWorkerExit()
+{
+    if (!gSoundDecoderWorkerRunning) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gSoundDecoderWorkerMutex);
+        gSoundDecoderWorkerShouldStop = true;
+    }
+
+    gSoundDecoderWorkerCondition.notify_all();
+
+    for (auto& thread : gSoundDecoderWorkerThreads) {
+        thread.join();
+    }
+
+    gSoundDecoderWorkerThreads.clear();
+    gSoundDecoderWorkerRunning = false;
+}
+
+void soundDecoderWorkerGetStats(SoundDecoderWorkerStats* stats)
+{
+    {
+        std::lock_guard<std::mutex> lock(gSoundDecoderWorkerMutex);
+        stats->streams = static_cast<int>(gSoundDecoderWorkerStreams.size());
+    }
+
+    stats->blocksDecoded = gSoundDecoderWorkerBlocksDecoded.load(std::memory_order_relaxed);
+    stats->underruns = gSoundDecoderWorkerUnderruns.load(std::memory_order_relaxed);
+}
+
+// Attaches decode-ahead ring to the specified decoder. Returns `nullptr` when
+// background decoding is not available, in this case the caller is expected to
+// use the decoder directly.
+//
+// The decoder must not be used directly while the stream is open.
+SoundDecoderStream* soundDecoderStreamOpen(SoundDecoder* soundDecoder, int latency)
+{
+    if (!gSoundDecoderWorkerRunning) {
+        return nullptr;
+    }
+
+    if (soundDecoder == nullptr) {
+        return nullptr;
+    }
+
+    // Decoder always outputs 16-bit samples.
+    int bytesPerSecond = soundDecoder->rate * soundDecoder->channels * 2;
+    int blocksLength = (bytesPerSecond / 1000 * latency + SOUND_DECODER_STREAM_BLOCK_SIZE - 1) / SOUND_DECODER_STREAM_BLOCK_SIZE;
+
+    unsigned int ringLength = SOUND_DECODER_STREAM_MIN_BLOCKS;
+    while (ringLength < static_cast<unsigned int>(blocksLength) && ringLength < SOUND_DECODER_STREAM_MAX_BLOCKS) {
+        ringLength <<= 1;
+    }
+
+    SoundDecoderStream* stream = new SoundDecoderStream();
+    stream->soundDecoder = soundDecoder;
+    stream->blocksLength = ringLength;
+    stream->head.store(0);
+    stream->tail.store(0);
+    stream->eof.store(false);
+    stream->readOffset = 0;
+    stream->primed = false;
+    stream->busy = false;
+    stream->underruns = 0;
+
+    stream->blocks = (SoundDecoderStreamBlock*)malloc(sizeof(*stream->blocks) * ringLength);
+    unsigned char* data = (unsigned char*)malloc(SOUND_DECODER_STREAM_BLOCK_SIZE * ringLength);
+    if (stream->blocks == nullptr || data == nullptr) {
+        free(data);
+        free(stream->blocks);
+        delete stream;
+        return nullptr;
+    }
+
+    for (unsigned int index = 0; index < ringLength; index++) {
+        stream->blocks[index].data = data + SOUND_DECODER_STREAM_BLOCK_SIZE * index;
+        stream->blocks[index].size = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gSoundDecoderWorkerMutex);
+        gSoundDecoderWorkerStreams.push_back(stream);
+    }
+
+    gSoundDecoderWorkerCondition.notify_one();
+
+    return stream;
+}
+
+// Detaches stream from the workers and releases the ring. The underlying
+// decoder is not freed, it's still owned by the caller.
+void soundDecoderStreamClose(SoundDecoderStream* stream)
+{
+    {
+        std::unique_lock<std::mutex> lock(gSoundDecoderWorkerMutex);
+
+        auto it = std::find(gSoundDecoderWorkerStreams.begin(), gSoundDecoderWorkerStreams.end(), stream);
+        if (it != gSoundDecoderWorkerStreams.end()) {
+            gSoundDecoderWorkerStreams.erase(it);
+        }
+
+        gSoundDecoderWorkerIdleCondition.wait(lock, [stream]() { return !stream->busy; });
+    }
+
+    free(stream->blocks[0].data);
+    free(stream->blocks);
+    delete stream;
+}
+
+// Reads decoded samples. Behaves exactly like `soundDecoderDecode`, but takes
+// blocks prepared by workers and only decodes synchronously when the reader
+// outpaced them.
+size_t soundDecoderStreamRead(SoundDecoderStream* stream, void* buffer, size_t size)
+{
+    unsigned char* dest = (unsigned char*)buffer;
+    size_t bytesRead = 0;
+    bool consumed = false;
+
+    while (bytesRead < size) {
+        unsigned int tail = stream->tail.load(std::memory_order_relaxed);
+        if (tail == stream->head.load(std::memory_order_acquire)) {
+            if (stream->eof.load(std::memory_order_acquire)) {
+                // The last block is published before eof is raised, so it
+                // might have been added since we checked.
+                if (tail == stream->head.load(std::memory_order_acquire)) {
+                    break;
+                }
+                continue;
+            }
+
+            if (stream->primed) {
+                stream->underruns++;
+                gSoundDecoderWorkerUnderruns.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            soundDecoderStreamProduce(stream);
+            continue;
+        }
+
+        SoundDecoderStreamBlock* block = &(stream->blocks[tail & (stream->blocksLength - 1)]);
+        size_t chunkSize = std::min(block->size - stream->readOffset, size - bytesRead);
+        memcpy(dest + bytesRead, block->data + stream->readOffset, chunkSize);
+        bytesRead += chunkSize;
+        stream->readOffset += chunkSize;
+
+        if (stream->readOffset == block->size) {
+            stream->readOffset = 0;
+            stream->tail.store(tail + 1, std::memory_order_release);
+            consumed = true;
+        }
+    }
+
+    stream->primed = true;
+
+    if (consumed) {
+        soundDecoderWorkerWakeUp();
+    }
+
+    return bytesRead;
+}
+
+static void soundDecoderWorkerProc()
+{
+    std::unique_lock<std::mutex> lock(gSoundDecoderWorkerMutex);
+    while (!gSoundDecoderWorkerShouldStop) {
+        SoundDecoderStream* stream = soundDecoderWorkerFindStream();
+        if (stream == nullptr) {
+            gSoundDecoderWorkerCondition.wait(lock);
+            continue;
+        }
+
+        stream->busy = true;
+        lock.unlock();
+
+        while (soundDecoderStreamProduce(stream)) {
+            gSoundDecoderWorkerBlocksDecoded.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        lock.lock();
+        stream->busy = false;
+        gSoundDecoderWorkerIdleCondition.notify_all();
+    }
+}
+
+// NOTE: Must be called with [gSoundDecoderWorkerMutex] held.
+static SoundDecoderStream* soundDecoderWorkerFindStream()
+{
+    for (SoundDecoderStream* stream : gSoundDecoderWorkerStreams) {
+        if (!stream->busy && soundDecoderStreamNeedsData(stream)) {
+            return stream;
+        }
+    }
+
+    return nullptr;
+}
+
+static void soundDecoderWorkerWakeUp()
+{
+    if (!gSoundDecoderWorkerRunning) {
+        return;
+    }
+
+    // Acquire mutex to make sure worker is either scanning streams (and will
+    // see the freed block), or already waiting for notification.
+    {
+        std::lock_guard<std::mutex> lock(gSoundDecoderWorkerMutex);
+    }
+
+    gSoundDecoderWorkerCondition.notify_one();
+}
+
+static bool soundDecoderStreamNeedsData(SoundDecoderStream* stream)
+{
+    if (stream->eof.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    unsigned int head = stream->head.load(std::memory_order_acquire);
+    unsigned int tail = stream->tail.load(std::memory_order_acquire);
+    return head - tail < stream->blocksLength;
+}
+
+// Decodes next block into the ring. Returns `false` when there is nothing to
+// do - the ring is full or decoder is exhausted.
+static bool soundDecoderStreamProduce(SoundDecoderStream* stream)
+{
+    std::lock_guard<std::mutex> lock(stream->decodeMutex);
+
+    if (stream->eof.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    unsigned int head = stream->head.load(std::memory_order_relaxed);
+    unsigned int tail = stream->tail.load(std::memory_order_acquire);
+    if (head - tail >= stream->blocksLength) {
+        return false;
+    }
+
+    SoundDecoderStreamBlock* block = &(stream->blocks[head & (stream->blocksLength - 1)]);
+    block->size = soundDecoderDecode(stream->soundDecoder, block->data, SOUND_DECODER_STREAM_BLOCK_SIZE);
+
+    stream->head.store(head + 1, std::memory_order_release);
+
+    if (block->size < SOUND_DECODER_STREAM_BLOCK_SIZE) {
+        stream->eof.store(true, std::memory_order_release);
+    }
+
+    return true;
+}
+
+} // namespace fallout
@@ -0,0 +1,38 @@
+#ifndef SOUND_DECODER_WORKER_H
+#define SOUND_DECODER_WORKER_H
+
+#include <stddef.h>
+
+#include "sound_decoder.h"
+
+namespace fallout {
+
+// Amount of decoded audio (in milliseconds) each stream tries to keep ahead of
+// the reader.
+#define SOUND_DECODER_STREAM_DEFAULT_LATENCY (750)
+
+typedef struct SoundDecoderStream SoundDecoderStream;
+
+typedef struct SoundDecoderWorkerStats {
+    // Number of streams currently attached to the worker.
+    int streams;
+
+    // Number of blocks decoded in the background.
+    unsigned int blocksDecoded;
+
+    // Number of blocks the reader had to decode by itself because nothing
+    // was ready yet.
+    unsigned int underruns;
+} SoundDecoderWorkerStats;
+
+bool soundDecoderWorkerInit();
+void soundDecoderWorkerExit();
+void soundDecoderWorkerGetStats(SoundDecoderWorkerStats* stats);
+
+SoundDecoderStream* soundDecoderStreamOpen(SoundDecoder* soundDecoder, int latency);
+void soundDecoderStreamClose(SoundDecoderStream* stream);
+size_t soundDecoderStreamRead(SoundDecoderStream* stream, void* buffer, size_t size);
+
+} // namespace fallout
+
+#endif /* SOUND_DECODER_WORKER_H */
@@ -1,5 +1,6 @@
 #include "stat.h"
 
+#include <stdint.h>
 #include <stdio.h>
 
 #include <algorithm>
@@ -11,6 +12,7 @@
 #include "display_monitor.h"
 #include "game.h"
 #include "game_sound.h"
+#include "input.h"
 #include "interface.h"
 #include "item.h"
 #include "memory.h"
@@ -29,6 +31,9 @@
 
 namespace fallout {
 
+// CE: Number of critters which derived stats are cached at the same time.
+#define STAT_CACHE_SIZE 64
+
 // Provides metadata about stats.
 typedef struct StatDescription {
     char* name;
@@ -39,6 +44,24 @@ typedef struct StatDescription {
     int defaultValue;
 } StatDescription;
 
+// CE: Cached part of saveable stats of a single critter, see
+// |critterGetStat|. Entry is valid only while its generation matches
+// |gStatCacheGeneration|.
+typedef struct StatCacheEntry {
+    Object* critter;
+    int pid;
+    unsigned int generation;
+    // Bitmask of stats in |values| which are computed.
+    unsigned long long validStats;
+    int values[SAVEABLE_STAT_COUNT];
+} StatCacheEntry;
+
+static_assert(SAVEABLE_STAT_COUNT <= 64, "validStats is too small");
+
+static int critterGetCachedStat(Object* critter, int stat);
+static int critterComputeStableStat(Object* critter, int stat);
+static int critterGetVolatileStatModifier(Object* critter, int stat);
+
 // 0x51D53C
 static StatDescription gStatDescriptions[STAT_COUNT] = {
     { nullptr, nullptr, 0, PRIMARY_STAT_MIN, PRIMARY_STAT_MAX, 5 },
@@ -99,6 +122,9 @@ static char* gStatValueDescriptions[PRIMARY_STAT_RANGE];
 // 0x6681AC
 static int gPcStatValues[PC_STAT_COUNT];
 
+static StatCacheEntry gStatCache[STAT_CACHE_SIZE];
+static unsigned int gStatCacheGeneration = 1;
+
 // 0x4AED70
 int statsInit()
 {
@@ -134,6 +160,9 @@ int statsInit()
 
     messageListRepositorySetStandardMessageList(STANDARD_MESSAGE_LIST_STAT, &gStatsMessageList);
 
+    // CE: Cached stats never outlive a single frame, see |critterGetStat|.
+    tickersAdd(statsInvalidateCache);
+
     return 0;
 }
 
@@ -143,12 +172,16 @@ int statsReset()
     // NOTE: Uninline.
     pcStatsReset();
 
+    statsInvalidateCache();
+
     return 0;
 }
 
 // 0x4AEEE4
 int statsExit()
 {
+    tickersRemove(statsInvalidateCache);
+
     messageListRepositorySetStandardMessageList(STANDARD_MESSAGE_LIST_STAT, nullptr);
     messageListFree(&gStatsMessageList);
 
@@ -188,203 +221,288 @@ int critterGetStat(Object* critter, int stat)
     }
     int value;
     if (stat >= 0 && stat < SAVEABLE_STAT_COUNT) {
-        value = critterGetBaseStatWithTraitModifier(critter, stat);
-        value += critterGetBonusStat(critter, stat);
+        // CE: The value is split into two parts. The first one depends on
+        // proto, traits, perks and inventory weight, it's expensive to
+        // compute (inventory walk in particular) and is cached. The second
+        // one depends on combat state, hit points, game time and equipped
+        // items, it's cheap and is always computed.
+        value = critterGetCachedStat(critter, stat);
+        value += critterGetVolatileStatModifier(critter, stat);
 
+        value = std::clamp(value, gStatDescriptions[stat].minimumValue, gStatDescriptions[stat].maximumValue);
+    } else {
         switch (stat) {
+        case STAT_CURRENT_HIT_POINTS:
+            value = critterGetHitPoints(critter);
+            break;
+        case STAT_CURRENT_POISON_LEVEL:
+            value = critterGetPoison(critter);
+            break;
+        case STAT_CURRENT_RADIATION_LEVEL:
+            value = critterGetRadiation(critter);
+            break;
+        default:
+            value = 0;
+            break;
+        }
+    }
+
+    return value;
+}
+
+// CE: Invalidates cached stats of all critters. Must be called whenever
+// something cached stats depend on is changed (see
+// |critterComputeStableStat|). As a safety net it's also called once per
+// frame.
+void statsInvalidateCache()
+{
+    gStatCacheGeneration++;
+
+    // Zero generation denotes unused entry.
+    if (gStatCacheGeneration == 0) {
+        gStatCacheGeneration = 1;
+    }
+}
+
+static int critterGetCachedStat(Object* critter, int stat)
+{
+    StatCacheEntry* entry = &(gStatCache[(reinterpret_cast<uintptr_t>(critter) >> 4) % STAT_CACHE_SIZE]);
+    if (entry->critter != critter || entry->pid != critter->pid || entry->generation != gStatCacheGeneration) {
+        entry->critter = critter;
+        entry->pid = critter->pid;
+        entry->generation = gStatCacheGeneration;
+        entry->validStats = 0;
+    }
+
+    unsigned long long mask = 1ULL << stat;
+    if ((entry->validStats & mask) != 0) {
+#ifndef NDEBUG
+        int value = critterComputeStableStat(critter, stat);
+        if (value != entry->values[stat]) {
+            debugPrint("Error: critterGetStat: Stale cached stat pid=%x stat=%i cached=%d actual=%d!\n",
+                critter->pid,
+                stat,
+                entry->values[stat],
+                value);
+            entry->values[stat] = value;
+        }
+#endif
+        return entry->values[stat];
+    }
+
+    int value = critterComputeStableStat(critter, stat);
+
+    // Entry might have been reused during computation.
+    if (entry->critter == critter && entry->pid == critter->pid && entry->generation == gStatCacheGeneration) {
+        entry->values[stat] = value;
+        entry->validStats |= mask;
+    }
+
+    return value;
+}
+
+// Returns part of saveable stat which depends on proto, traits, perks and
+// inventory weight.
+static int critterComputeStableStat(Object* critter, int stat)
+{
+    int value = critterGetBaseStatWithTraitModifier(critter, stat);
+    value += critterGetBonusStat(critter, stat);
+
+    switch (stat) {
+    case STAT_MAXIMUM_ACTION_POINTS:
+        if (1) {
+            int remainingCarryWeight = critterGetStat(critter, STAT_CARRY_WEIGHT) - objectGetInventoryWeight(critter);
+            if (remainingCarryWeight < 0) {
+                value -= -remainingCarryWeight / 40 + 1;
+            }
+        }
+        break;
+    }
+
+    if (critter == gDude) {
+        switch (stat) {
+        case STAT_STRENGTH:
+            if (perkGetRank(critter, PERK_GAIN_STRENGTH)) {
+                value++;
+            }
+            break;
         case STAT_PERCEPTION:
-            if ((critter->data.critter.combat.results & DAM_BLIND) != 0) {
-                value -= 5;
+            if (perkGetRank(critter, PERK_GAIN_PERCEPTION)) {
+                value++;
             }
             break;
-        case STAT_MAXIMUM_ACTION_POINTS:
-            if (1) {
-                int remainingCarryWeight = critterGetStat(critter, STAT_CARRY_WEIGHT) - objectGetInventoryWeight(critter);
-                if (remainingCarryWeight < 0) {
-                    value -= -remainingCarryWeight / 40 + 1;
-                }
+        case STAT_ENDURANCE:
+            if (perkGetRank(critter, PERK_GAIN_ENDURANCE)) {
+                value++;
             }
             break;
-        case STAT_ARMOR_CLASS:
-            if (isInCombat()) {
-                if (_combat_whose_turn() != critter) {
-                    int actionPointsMultiplier = 1;
-                    int hthEvadeBonus = 0;
-
-                    if (critter == gDude) {
-                        if (perkHasRank(gDude, PERK_HTH_EVADE)) {
-                            bool hasWeapon = false;
-
-                            Object* item2 = critterGetItem2(gDude);
-                            if (item2 != nullptr) {
-                                if (itemGetType(item2) == ITEM_TYPE_WEAPON) {
-                                    if (weaponGetAnimationCode(item2) != WEAPON_ANIMATION_NONE) {
-                                        hasWeapon = true;
-                                    }
-                                }
-                            }
-
-                            if (!hasWeapon) {
-                                Object* item1 = critterGetItem1(gDude);
-                                if (item1 != nullptr) {
-                                    if (itemGetType(item1) == ITEM_TYPE_WEAPON) {
-                                        if (weaponGetAnimationCode(item1) != WEAPON_ANIMATION_NONE) {
-                                            hasWeapon = true;
-                                        }
-                                    }
-                                }
-                            }
-
-                            if (!hasWeapon) {
-                                actionPointsMultiplier = 2;
-                                hthEvadeBonus = skillGetValue(gDude, SKILL_UNARMED) / 12;
-                            }
-                        }
-                    }
-                    value += hthEvadeBonus;
-                    value += critter->data.critter.combat.ap * actionPointsMultiplier;
-                }
+        case STAT_CHARISMA:
+            if (perkGetRank(critter, PERK_GAIN_CHARISMA)) {
+                value++;
             }
             break;
-        case STAT_AGE:
-            value += gameTimeGetTime() / GAME_TIME_TICKS_PER_YEAR;
+        case STAT_INTELLIGENCE:
+            if (perkGetRank(critter, PERK_GAIN_INTELLIGENCE)) {
+                value++;
+            }
             break;
-        }
+        case STAT_AGILITY:
+            if (perkGetRank(critter, PERK_GAIN_AGILITY)) {
+                value++;
+            }
+            break;
+        case STAT_LUCK:
+            if (perkGetRank(critter, PERK_GAIN_LUCK)) {
+                value++;
+            }
+            break;
+        case STAT_MAXIMUM_HIT_POINTS:
+            if (perkGetRank(critter, PERK_ALCOHOL_RAISED_HIT_POINTS)) {
+                value += 2;
+            }
 
-        if (critter == gDude) {
-            switch (stat) {
-            case STAT_STRENGTH:
-                if (perkGetRank(critter, PERK_GAIN_STRENGTH)) {
-                    value++;
-                }
+            if (perkGetRank(critter, PERK_ALCOHOL_RAISED_HIT_POINTS_II)) {
+                value += 4;
+            }
 
-                if (perkGetRank(critter, PERK_ADRENALINE_RUSH)) {
-                    if (critterGetStat(critter, STAT_CURRENT_HIT_POINTS) < (critterGetStat(critter, STAT_MAXIMUM_HIT_POINTS) / 2)) {
-                        value++;
-                    }
-                }
-                break;
-            case STAT_PERCEPTION:
-                if (perkGetRank(critter, PERK_GAIN_PERCEPTION)) {
-                    value++;
-                }
-                break;
-            case STAT_ENDURANCE:
-                if (perkGetRank(critter, PERK_GAIN_ENDURANCE)) {
-                    value++;
-                }
-                break;
-            case STAT_CHARISMA:
-                if (1) {
-                    if (perkGetRank(critter, PERK_GAIN_CHARISMA)) {
-                        value++;
-                    }
+            if (perkGetRank(critter, PERK_ALCOHOL_LOWERED_HIT_POINTS)) {
+                value -= 2;
+            }
 
-                    bool hasMirrorShades = false;
+            if (perkGetRank(critter, PERK_ALCOHOL_LOWERED_HIT_POINTS_II)) {
+                value -= 4;
+            }
 
-                    Object* item2 = critterGetItem2(critter);
-                    if (item2 != nullptr && item2->pid == PROTO_ID_MIRRORED_SHADES) {
-                        hasMirrorShades = true;
-                    }
+            if (perkGetRank(critter, PERK_AUTODOC_RAISED_HIT_POINTS)) {
+                value += 2;
+            }
 
-                    Object* item1 = critterGetItem1(critter);
-                    if (item1 != nullptr && item1->pid == PROTO_ID_MIRRORED_SHADES) {
-                        hasMirrorShades = true;
-                    }
+            if (perkGetRank(critter, PERK_AUTODOC_RAISED_HIT_POINTS_II)) {
+                value += 4;
+            }
 
-                    if (hasMirrorShades) {
-                        value++;
-                    }
-                }
-                break;
-            case STAT_INTELLIGENCE:
-                if (perkGetRank(critter, PERK_GAIN_INTELLIGENCE)) {
-                    value++;
-                }
-                break;
-            case STAT_AGILITY:
-                if (perkGetRank(critter, PERK_GAIN_AGILITY)) {
-                    value++;
-                }
-                break;
-            case STAT_LUCK:
-                if (perkGetRank(critter, PERK_GAIN_LUCK)) {
-                    value++;
-                }
-                break;
-            case STAT_MAXIMUM_HIT_POINTS:
-                if (perkGetRank(critter, PERK_ALCOHOL_RAISED_HIT_POINTS)) {
-                    value += 2;
-                }
+            if (perkGetRank(critter, PERK_AUTODOC_LOWERED_HIT_POINTS)) {
+                value -= 2;
+            }
 
-                if (perkGetRank(critter, PERK_ALCOHOL_RAISED_HIT_POINTS_II)) {
-                    value += 4;
-                }
+            if (perkGetRank(critter, PERK_AUTODOC_LOWERED_HIT_POINTS_II)) {
+                value -= 4;
+            }
+            break;
+        case STAT_DAMAGE_RESISTANCE:
+        case STAT_DAMAGE_RESISTANCE_EXPLOSION:
+            if (perkGetRank(critter, PERK_DERMAL_IMPACT_ARMOR)) {
+                value += 5;
+            } else if (perkGetRank(critter, PERK_DERMAL_IMPACT_ASSAULT_ENHANCEMENT)) {
+                value += 10;
+            }
+            break;
+        case STAT_DAMAGE_RESISTANCE_LASER:
+        case STAT_DAMAGE_RESISTANCE_FIRE:
+        case STAT_DAMAGE_RESISTANCE_PLASMA:
+            if (perkGetRank(critter, PERK_PHOENIX_ARMOR_IMPLANTS)) {
+                value += 5;
+            } else if (perkGetRank(critter, PERK_PHOENIX_ASSAULT_ENHANCEMENT)) {
+                value += 10;
+            }
+            break;
+        case STAT_RADIATION_RESISTANCE:
+        case STAT_POISON_RESISTANCE:
+            if (perkGetRank(critter, PERK_VAULT_CITY_INOCULATIONS)) {
+                value += 10;
+            }
+            break;
+        }
+    }
 
-                if (perkGetRank(critter, PERK_ALCOHOL_LOWERED_HIT_POINTS)) {
-                    value -= 2;
-                }
+    return value;
+}
 
-                if (perkGetRank(critter, PERK_ALCOHOL_LOWERED_HIT_POINTS_II)) {
-                    value -= 4;
-                }
+// Returns part of saveable stat which depends on combat state, hit points,
+// game time and equipped items.
+static int critterGetVolatileStatModifier(Object* critter, int stat)
+{
+    int value = 0;
 
-                if (perkGetRank(critter, PERK_AUTODOC_RAISED_HIT_POINTS)) {
-                    value += 2;
-                }
+    switch (stat) {
+    case STAT_PERCEPTION:
+        if ((critter->data.critter.combat.results & DAM_BLIND) != 0) {
+            value -= 5;
+        }
+        break;
+    case STAT_ARMOR_CLASS:
+        if (isInCombat()) {
+            if (_combat_whose_turn() != critter) {
+                int actionPointsMultiplier = 1;
+                int hthEvadeBonus = 0;
+
+                if (critter == gDude) {
+                    if (perkHasRank(gDude, PERK_HTH_EVADE)) {
+                        bool hasWeapon = false;
+
+                        Object* item2 = critterGetItem2(gDude);
+                        if (item2 != nullptr) {
+                            if (itemGetType(item2) == ITEM_TYPE_WEAPON) {
+                                if (weaponGetAnimationCode(item2) != WEAPON_ANIMATION_NONE) {
+                                    hasWeapon = true;
+                                }
+                            }
+                        }
 
-                if (perkGetRank(critter, PERK_AUTODOC_RAISED_HIT_POINTS_II)) {
-                    value += 4;
-                }
+                        if (!hasWeapon) {
+                            Object* item1 = critterGetItem1(gDude);
+                            if (item1 != nullptr) {
+                                if (itemGetType(item1) == ITEM_TYPE_WEAPON) {
+                                    if (weaponGetAnimationCode(item1) != WEAPON_ANIMATION_NONE) {
+                                        hasWeapon = true;
+                                    }
+                                }
+                            }
+                        }
 
-                if (perkGetRank(critter, PERK_AUTODOC_LOWERED_HIT_POINTS)) {
-                    value -= 2;
+                        if (!hasWeapon) {
+                            actionPointsMultiplier = 2;
+                            hthEvadeBonus = skillGetValue(gDude, SKILL_UNARMED) / 12;
+                        }
+                    }
                 }
+                value += hthEvadeBonus;
+                value += critter->data.critter.combat.ap * actionPointsMultiplier;
+            }
+        }
+        break;
+    case STAT_AGE:
+        value += gameTimeGetTime() / GAME_TIME_TICKS_PER_YEAR;
+        break;
+    }
 
-                if (perkGetRank(critter, PERK_AUTODOC_LOWERED_HIT_POINTS_II)) {
-                    value -= 4;
+    if (critter == gDude) {
+        switch (stat) {
+        case STAT_STRENGTH:
+            if (perkGetRank(critter, PERK_ADRENALINE_RUSH)) {
+                if (critterGetStat(critter, STAT_CURRENT_HIT_POINTS) < (critterGetStat(critter, STAT_MAXIMUM_HIT_POINTS) / 2)) {
+                    value++;
                 }
-                break;
-            case STAT_DAMAGE_RESISTANCE:
-            case STAT_DAMAGE_RESISTANCE_EXPLOSION:
-                if (perkGetRank(critter, PERK_DERMAL_IMPACT_ARMOR)) {
-                    value += 5;
-                } else if (perkGetRank(critter, PERK_DERMAL_IMPACT_ASSAULT_ENHANCEMENT)) {
-                    value += 10;
+            }
+            break;
+        case STAT_CHARISMA:
+            if (1) {
+                bool hasMirrorShades = false;
+
+                Object* item2 = critterGetItem2(critter);
+                if (item2 != nullptr && item2->pid == PROTO_ID_MIRRORED_SHADES) {
+                    hasMirrorShades = true;
                 }
-                break;
-            case STAT_DAMAGE_RESISTANCE_LASER:
-            case STAT_DAMAGE_RESISTANCE_FIRE:
-            case STAT_DAMAGE_RESISTANCE_PLASMA:
-                if (perkGetRank(critter, PERK_PHOENIX_ARMOR_IMPLANTS)) {
-                    value += 5;
-                } else if (perkGetRank(critter, PERK_PHOENIX_ASSAULT_ENHANCEMENT)) {
-                    value += 10;
+
+                Object* item1 = critterGetItem1(critter);
+                if (item1 != nullptr && item1->pid == PROTO_ID_MIRRORED_SHADES) {
+                    hasMirrorShades = true;
                 }
-                break;
-            case STAT_RADIATION_RESISTANCE:
-            case STAT_POISON_RESISTANCE:
-                if (perkGetRank(critter, PERK_VAULT_CITY_INOCULATIONS)) {
-                    value += 10;
+
+                if (hasMirrorShades) {
+                    value++;
                 }
-                break;
             }
-        }
-
-        value = std::clamp(value, gStatDescriptions[stat].minimumValue, gStatDescriptions[stat].maximumValue);
-    } else {
-        switch (stat) {
-        case STAT_CURRENT_HIT_POINTS:
-            value = critterGetHitPoints(critter);
-            break;
-        case STAT_CURRENT_POISON_LEVEL:
-            value = critterGetPoison(critter);
-            break;
-        case STAT_CURRENT_RADIATION_LEVEL:
-            value = critterGetRadiation(critter);
-            break;
-        default:
-            value = 0;
             break;
         }
     }
@@ -480,6 +598,8 @@ int critterSetBaseStat(Object* critter, int stat, int value)
         protoGetProto(critter->pid, &proto);
         proto->critter.data.baseStats[stat] = value;
 
+        statsInvalidateCache();
+
         if (stat >= STAT_STRENGTH && stat <= STAT_LUCK) {
             critterUpdateDerivedStats(critter);
         }
@@ -536,6 +656,8 @@ int critterSetBonusStat(Object* critter, int stat, int value)
         protoGetProto(critter->pid, &proto);
         proto->critter.data.bonusStats[stat] = value;
 
+        statsInvalidateCache();
+
         if (stat >= STAT_STRENGTH && stat <= STAT_LUCK) {
             critterUpdateDerivedStats(critter);
         }
@@ -563,6 +685,8 @@ void protoCritterDataResetStats(CritterProtoData* data)
         data->baseStats[stat] = gStatDescriptions[stat].defaultValue;
         data->bonusStats[stat] = 0;
     }
+
+    statsInvalidateCache();
 }
 
 // 0x4AF6FC
@@ -590,6 +714,8 @@ void critterUpdateDerivedStats(Object* critter)
     data->baseStats[STAT_BETTER_CRITICALS] = 0;
     data->baseStats[STAT_RADIATION_RESISTANCE] = 2 * endurance;
     data->baseStats[STAT_POISON_RESISTANCE] = 5 * endurance;
+
+    statsInvalidateCache();
 }
 
 // 0x4AF854
@@ -16,6 +16,7 @@ int statsExit();
 int statsLoad(File* stream);
 int statsSave(File* stream);
 int critterGetStat(Object* critter, int stat);
+void statsInvalidateCache();
 int critterGetBaseStatWithTraitModifier(Object* critter, int stat);
 int critterGetBaseStat(Object* critter, int stat);
 int critterGetBonusStat(Object* critter, int stat);
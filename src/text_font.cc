@@ -37,8 +37,15 @@ typedef struct TextFontDescriptor {
 
     TextFontGlyph* glyphs;
     unsigned char* data;
+
+    // CE: Pre-rasterized glyphs, see |textFontBuildRuns|.
+    unsigned short* runs;
+
+    // CE: Offsets into |runs| for every glyph.
+    int* runOffsets;
 } TextFontDescriptor;
 
+static int textFontBuildRuns(TextFontDescriptor* textFontDescriptor);
 static void textFontSetCurrentImpl(int font);
 static bool fontManagerFind(int font, FontManager** fontManagerPtr);
 static void textFontDrawImpl(unsigned char* buf, const char* string, int length, int pitch, int color);
@@ -143,6 +150,8 @@ void textFontsExit()
         if (textFontDescriptor->glyphCount != 0) {
             internal_free(textFontDescriptor->glyphs);
             internal_free(textFontDescriptor->data);
+            internal_free(textFontDescriptor->runs);
+            internal_free(textFontDescriptor->runOffsets);
         }
     }
 }
@@ -155,6 +164,8 @@ int textFontLoad(int font)
     TextFontDescriptor* textFontDescriptor = &(gTextFontDescriptors[font]);
     textFontDescriptor->data = nullptr;
     textFontDescriptor->glyphs = nullptr;
+    textFontDescriptor->runs = nullptr;
+    textFontDescriptor->runOffsets = nullptr;
 
     File* stream = nullptr;
     char path[COMPAT_MAX_PATH];
@@ -212,6 +223,10 @@ int textFontLoad(int font)
         goto out;
     }
 
+    if (textFontBuildRuns(textFontDescriptor) == -1) {
+        goto out;
+    }
+
     rc = 0;
 
 out:
@@ -226,6 +241,16 @@ out:
             internal_free(textFontDescriptor->glyphs);
             textFontDescriptor->glyphs = nullptr;
         }
+
+        if (textFontDescriptor->runs != nullptr) {
+            internal_free(textFontDescriptor->runs);
+            textFontDescriptor->runs = nullptr;
+        }
+
+        if (textFontDescriptor->runOffsets != nullptr) {
+            internal_free(textFontDescriptor->runOffsets);
+            textFontDescriptor->runOffsets = nullptr;
+        }
     }
 
     if (stream != nullptr) {
@@ -235,6 +260,93 @@ out:
     return rc;
 }
 
+// CE: Converts glyph bitmaps into horizontal runs of set pixels, so glyphs
+// can be drawn with a memset per run instead of testing every bit.
+//
+// Runs of every glyph are stored row by row: number of runs in a row followed
+// by x offset and length of every run.
+static int textFontBuildRuns(TextFontDescriptor* textFontDescriptor)
+{
+    int lineHeight = textFontDescriptor->lineHeight;
+
+    // Characters above 0x7F pass glyph count check in |textFontDrawImpl| (due
+    // to sign), so offsets are provided for every character. Missing glyphs
+    // are blank.
+    int runOffsetsLength = textFontDescriptor->glyphCount > 256 ? textFontDescriptor->glyphCount : 256;
+    textFontDescriptor->runOffsets = (int*)internal_malloc(sizeof(*textFontDescriptor->runOffsets) * runOffsetsLength);
+    if (textFontDescriptor->runOffsets == nullptr) {
+        return -1;
+    }
+
+    // Two passes: the first one measures, the second one fills runs.
+    for (int pass = 0; pass < 2; pass++) {
+        int runsLength = 0;
+        for (int index = 0; index < textFontDescriptor->glyphCount; index++) {
+            TextFontGlyph* glyph = &(textFontDescriptor->glyphs[index]);
+            unsigned char* glyphData = textFontDescriptor->data + glyph->dataOffset;
+            int rowSize = (glyph->width + 7) >> 3;
+
+            if (pass == 1) {
+                textFontDescriptor->runOffsets[index] = runsLength;
+            }
+
+            for (int y = 0; y < lineHeight; y++) {
+                int countIndex = runsLength++;
+                int count = 0;
+
+                int x = 0;
+                while (x < glyph->width) {
+                    if ((glyphData[x >> 3] & (0x80 >> (x & 7))) == 0) {
+                        x++;
+                        continue;
+                    }
+
+                    int start = x;
+                    while (x < glyph->width && (glyphData[x >> 3] & (0x80 >> (x & 7))) != 0) {
+                        x++;
+                    }
+
+                    if (pass == 1) {
+                        textFontDescriptor->runs[runsLength] = start;
+                        textFontDescriptor->runs[runsLength + 1] = x - start;
+                    }
+                    runsLength += 2;
+                    count++;
+                }
+
+                if (pass == 1) {
+                    textFontDescriptor->runs[countIndex] = count;
+                }
+
+                glyphData += rowSize;
+            }
+        }
+
+        // Blank glyph.
+        for (int index = textFontDescriptor->glyphCount; index < runOffsetsLength; index++) {
+            if (pass == 1) {
+                textFontDescriptor->runOffsets[index] = runsLength;
+            }
+        }
+
+        for (int y = 0; y < lineHeight; y++) {
+            if (pass == 1) {
+                textFontDescriptor->runs[runsLength] = 0;
+            }
+            runsLength++;
+        }
+
+        if (pass == 0) {
+            textFontDescriptor->runs = (unsigned short*)internal_malloc(sizeof(*textFontDescriptor->runs) * runsLength);
+            if (textFontDescriptor->runs == nullptr) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 // 0x4D5780
 int fontManagerAdd(FontManager* fontManager)
 {
@@ -347,24 +459,15 @@ static void textFontDrawImpl(unsigned char* buf, const char* string, int length,
                 break;
             }
 
-            unsigned char* glyphData = gCurrentTextFontDescriptor->data + glyph->dataOffset;
+            // CE: Draw pre-rasterized runs instead of testing every bit.
+            unsigned short* runs = gCurrentTextFontDescriptor->runs + gCurrentTextFontDescriptor->runOffsets[ch & 0xFF];
             for (int y = 0; y < gCurrentTextFontDescriptor->lineHeight; y++) {
-                int bits = 0x80;
-                for (int x = 0; x < glyph->width; x++) {
-                    if (bits == 0) {
-                        bits = 0x80;
-                        glyphData++;
-                    }
-
-                    if ((*glyphData & bits) != 0) {
-                        *ptr = color & 0xFF;
-                    }
-
-                    bits >>= 1;
-                    ptr++;
+                int count = *runs++;
+                for (int run = 0; run < count; run++) {
+                    memset(ptr + runs[0], color & 0xFF, runs[1]);
+                    runs += 2;
                 }
-                glyphData++;
-                ptr += pitch - glyph->width;
+                ptr += pitch;
             }
 
             ptr = end;
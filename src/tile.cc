@@ -15,6 +15,7 @@
 #include "game_mouse.h"
 #include "light.h"
 #include "map.h"
+#include "memory.h"
 #include "object.h"
 #include "platform_compat.h"
 #include "settings.h"
@@ -24,6 +25,33 @@
 
 namespace fallout {
 
+#define TILE_FLAG_ODD_COLUMN 0x01
+#define TILE_FLAG_EDGE 0x02
+
+// Floor chunks tile map space (screen space independent of the current center,
+// see `tileGetWorldOrigin`) covering every floor of 100x100 square grid.
+#define TILE_FLOOR_CHUNK_WIDTH 256
+#define TILE_FLOOR_CHUNK_HEIGHT 128
+#define TILE_FLOOR_CHUNK_ORIGIN_X (-256)
+#define TILE_FLOOR_CHUNK_ORIGIN_Y (-1280)
+#define TILE_FLOOR_CHUNK_COLUMNS 34
+#define TILE_FLOOR_CHUNK_ROWS 31
+#define TILE_FLOOR_CHUNK_CACHE_CAPACITY 128
+
+// Margins around tile's map position that contain all floor pixels affected by
+// light intensity of that tile (lighting samples tiles up to three rows and two
+// columns away from the floor's origin).
+#define TILE_FLOOR_LIGHT_MARGIN_X 224
+#define TILE_FLOOR_LIGHT_MARGIN_Y 112
+
+// Margins added to the part of floor chunk being rendered when selecting floors
+// to draw into it. Floors
+// are selected by square coordinates of the rect corners, which misses floors
+// only touching the corners. This is not visible at the window edges, but
+// leaves gaps between chunks.
+#define TILE_FLOOR_CHUNK_SELECTION_MARGIN_X 80
+#define TILE_FLOOR_CHUNK_SELECTION_MARGIN_Y 36
+
 typedef struct RightsideUpTableEntry {
     int field_0;
     int field_4;
@@ -52,6 +80,19 @@ typedef struct UpsideDownTriangle {
     int field_8;
 } UpsideDownTriangle;
 
+typedef struct TileFloorChunk {
+    // Elevation, column and row of the chunk, or -1 if slot is free.
+    int elevation;
+    int column;
+    int row;
+    unsigned int lastUsed;
+    unsigned char* pixels;
+
+    // Part of the chunk (in chunk coordinates) to render before use.
+    bool dirty;
+    Rect dirtyRect;
+} TileFloorChunk;
+
 struct roof_fill_task {
     int x;
     int y;
@@ -64,8 +105,18 @@ static void roof_fill_push_task_if_in_bounds(std::stack<roof_fill_task>& tasks_s
 static void roof_fill_off_process_task(std::stack<roof_fill_task>& tasks_stack, int elevation, bool on);
 static void tileRenderRoof(int fid, int x, int y, Rect* rect, int light);
 static void _draw_grid(int tile, int elevation, Rect* rect);
-static void tileRenderFloor(int fid, int x, int y, Rect* rect);
+static void tileRenderFloor(int fid, int x, int y, Rect* rect, unsigned char* dest, int destPitch, Rect* destRect);
+static void tileRenderFloorsInRectToBuffer(Rect* rect, int elevation, unsigned char* dest, int destPitch, Rect* destRect);
+static void tileGetWorldOrigin(int* xPtr, int* yPtr);
+static TileFloorChunk* tileFloorChunkGet(int elevation, int column, int row);
+static void tileFloorChunkFree(TileFloorChunk* chunk);
+static void tileFloorChunkInvalidateRect(TileFloorChunk* chunk, const Rect* rect);
+static void tileFloorChunkRender(TileFloorChunk* chunk, const Rect* rect);
+static void tileRenderFloorsFromCache(Rect* rect, int elevation);
 static int _tile_make_line(int currentCenterTile, int newCenterTile, int* tiles, int tilesCapacity);
+static void tileGeometryInit();
+static int tileGetParity(int tile);
+static int tileGetRotationToScreenOffset(int dx, int dy);
 
 // 0x50E7C7
 static double const dbl_50E7C7 = -4.0;
@@ -288,6 +339,33 @@ static int gTileWindowWidth;
 // 0x66BE34
 int gCenterTile;
 
+// CE: Hex grid geometry precomputed in `tileInit`.
+//
+// Screen position of every tile (top-left corner of its bounding box) as if
+// the view was centered on tile 0. Positions relative to the actual center are
+// obtained by subtracting position of the center column/row, which is cheap
+// since the center column is always even (see `tileSetCenter`).
+static short gTileScreenX[HEX_GRID_SIZE];
+static short gTileScreenY[HEX_GRID_SIZE];
+
+// Column parity (selects row in `_dir_tile`) and edge sentinel for every tile.
+// Neighbours are found by adding `_dir_tile` offsets.
+static unsigned char gTileFlags[HEX_GRID_SIZE];
+
+// Unit vectors along hex direction sector boundaries in screen space (y axis
+// pointing up), see `tileGetRotationToScreenOffset`.
+static double gTileRotationBoundaries[6][2];
+
+// CE: Lit floor pixels in map space. Floors are drawn first onto a cleared
+// window buffer, so a chunk is exactly what the original renderer produces in
+// its area. Chunks are dropped when squares, or light around them change.
+static TileFloorChunk gTileFloorChunks[TILE_FLOOR_CHUNK_CACHE_CAPACITY];
+
+// Index of chunk slot plus one, or zero if chunk is not cached.
+static unsigned char gTileFloorChunkSlots[ELEVATION_COUNT][TILE_FLOOR_CHUNK_ROWS][TILE_FLOOR_CHUNK_COLUMNS];
+
+static unsigned int gTileFloorChunksClock = 0;
+
 // 0x4B0C40
 int tileInit(TileData** a1, int squareGridWidth, int squareGridHeight, int hexGridWidth, int hexGridHeight, unsigned char* buf, int windowWidth, int windowHeight, int windowPitch, TileWindowRefreshProc* windowRefreshProc)
 {
@@ -322,6 +400,12 @@ int tileInit(TileData** a1, int squareGridWidth, int squareGridHeight, int hexGr
     _dir_tile2[1][2] = 1;
     gTileWindowRect.right = windowWidth - 1;
     gSquareGridSize = squareGridHeight * squareGridWidth;
+
+    // CE: Geometry tables are statically allocated.
+    if (gHexGridSize > HEX_GRID_SIZE) {
+        return -1;
+    }
+
     gTileWindowRect.bottom = windowHeight - 1;
     gTileWindowRect.left = 0;
     gTileWindowRefreshProc = windowRefreshProc;
@@ -344,6 +428,8 @@ int tileInit(TileData** a1, int squareGridWidth, int squareGridHeight, int hexGr
     _dir_tile2[1][0] = hexGridWidth + 1;
     _dir_tile2[1][3] = 1 - hexGridWidth;
 
+    tileGeometryInit();
+
     v11 = 0;
     v12 = 0;
     do {
@@ -503,6 +589,16 @@ void tileReset()
 void tileExit()
 {
     _tile_reset_();
+
+    // CE: Release floor chunks.
+    tileInvalidateFloorCache();
+    for (int index = 0; index < TILE_FLOOR_CHUNK_CACHE_CAPACITY; index++) {
+        TileFloorChunk* chunk = &(gTileFloorChunks[index]);
+        if (chunk->pixels != nullptr) {
+            internal_free(chunk->pixels);
+            chunk->pixels = nullptr;
+        }
+    }
 }
 
 // 0x4B12A8
@@ -684,37 +780,14 @@ int tileRoofIsVisible()
 // 0x4B1674
 int tileToScreenXY(int tile, int* screenX, int* screenY, int elevation)
 {
-    int v3;
-    int v4;
-    int v5;
-    int v6;
-
     if (!tileIsValid(tile)) {
         return -1;
     }
 
-    v3 = gHexGridWidth - 1 - tile % gHexGridWidth;
-    v4 = tile / gHexGridWidth;
-
-    *screenX = _tile_offx;
-    *screenY = _tile_offy;
-
-    v5 = (v3 - _tile_x) / -2;
-    *screenX += 48 * ((v3 - _tile_x) / 2);
-    *screenY += 12 * v5;
-
-    if (v3 & 1) {
-        if (v3 <= _tile_x) {
-            *screenX -= 16;
-            *screenY += 12;
-        } else {
-            *screenX += 32;
-        }
-    }
-
-    v6 = v4 - _tile_y;
-    *screenX += 16 * v6;
-    *screenY += 12 * v6;
+    // CE: Original code derived position from tile column and row on every
+    // call, see `tileGeometryInit`.
+    *screenX = _tile_offx + gTileScreenX[tile] - (24 * _tile_x + 16 * _tile_y);
+    *screenY = _tile_offy + gTileScreenY[tile] - (-6 * _tile_x + 12 * _tile_y);
 
     return 0;
 }
@@ -803,7 +876,7 @@ int tileDistanceBetween(int tile1, int tile2)
     for (; curTile != tile2; step++) {
         int dir = tileGetRotationTo(curTile, tile2);
 
-        curTile += _dir_tile[curTile % gHexGridWidth & 1][dir];
+        curTile += _dir_tile[tileGetParity(curTile)][dir];
     }
 
     return step;
@@ -853,8 +926,7 @@ int tileGetTileInDirection(int tile, int rotation, int distance)
             break;
         }
 
-        int parity = (newTile % gHexGridWidth) & 1;
-        newTile += _dir_tile[parity][rotation];
+        newTile += _dir_tile[tileGetParity(newTile)][rotation];
     }
 
     return newTile;
@@ -870,25 +942,40 @@ int tileGetRotationTo(int tile1, int tile2)
     int x2, y2;
     tileToScreenXY(tile2, &x2, &y2, 0);
 
-    int dy = y2 - y1;
-    int dx = x2 - x1;
+    return tileGetRotationToScreenOffset(x2 - x1, y2 - y1);
+}
 
-    if (dx != 0) {
-        int raw = (int)trunc(atan2((double)-dy, (double)dx) * 180.0 / M_PI); // radians -> degrees
-        int angle = 360 - (raw + 180) - 90;
-        if (angle < 0) {
-            angle += 360;
-        }
+// CE: Original code converted `atan2` of the offset to whole degrees
+// (truncating towards zero) and split the result into 60 degree sectors. Since
+// only the sector matters this is done with cross products against sector
+// boundaries instead. Truncation moves boundaries to 31, 91 and 151 degrees
+// above horizontal and keeps them at 30, 90 and 150 degrees below it.
+static int tileGetRotationToScreenOffset(int dx, int dy)
+{
+    if (dx == 0) {
+        return dy < 0 ? ROTATION_NE : ROTATION_SE;
+    }
 
-        angle /= 60; // convert from degrees to hex direction
+    double x = dx;
+    double y = -dy;
 
-        if (angle >= ROTATION_COUNT) {
-            angle = ROTATION_NW;
+    if (y >= 0) {
+        for (int index = 0; index < 3; index++) {
+            if (gTileRotationBoundaries[index][0] * y - gTileRotationBoundaries[index][1] * x < 0) {
+                // E, NE, NW
+                return (ROTATION_E + ROTATION_COUNT - index) % ROTATION_COUNT;
+            }
+        }
+    } else {
+        for (int index = 3; index < 6; index++) {
+            if (gTileRotationBoundaries[index][0] * y - gTileRotationBoundaries[index][1] * x > 0) {
+                // E, SE, SW
+                return ROTATION_E + index - 3;
+            }
         }
-        return angle;
     }
 
-    return dy < 0 ? ROTATION_NE : ROTATION_SE;
+    return ROTATION_W;
 }
 
 // 0x4B1B84
@@ -987,23 +1074,51 @@ bool tileIsEdge(int tile)
         return false;
     }
 
-    if (tile < gHexGridWidth) {
-        return true;
-    }
+    return (gTileFlags[tile] & TILE_FLAG_EDGE) != 0;
+}
+
+// CE: Builds hex grid geometry tables, must be called once grid dimensions
+// are known.
+static void tileGeometryInit()
+{
+    for (int tile = 0; tile < gHexGridSize; tile++) {
+        int column = tile % gHexGridWidth;
+        int row = tile / gHexGridWidth;
+
+        // Columns are counted from the right on screen.
+        int screenColumn = gHexGridWidth - 1 - column;
+
+        gTileScreenX[tile] = static_cast<short>(24 * screenColumn + 8 * (screenColumn & 1) + 16 * row);
+        gTileScreenY[tile] = static_cast<short>(-6 * screenColumn + 6 * (screenColumn & 1) + 12 * row);
+
+        unsigned char flags = 0;
+        if ((column & 1) != 0) {
+            flags |= TILE_FLAG_ODD_COLUMN;
+        }
+
+        if (row == 0 || row == gHexGridHeight - 1 || column == 0 || column == gHexGridWidth - 1) {
+            flags |= TILE_FLAG_EDGE;
+        }
 
-    if (tile >= gHexGridSize - gHexGridWidth) {
-        return true;
+        gTileFlags[tile] = flags;
     }
 
-    if (tile % gHexGridWidth == 0) {
-        return true;
+    static const int boundaries[6] = { 31, 91, 151, -30, -90, -150 };
+    for (int index = 0; index < 6; index++) {
+        double radians = boundaries[index] * M_PI / 180.0;
+        gTileRotationBoundaries[index][0] = cos(radians);
+        gTileRotationBoundaries[index][1] = sin(radians);
     }
+}
 
-    if (tile % gHexGridWidth == gHexGridWidth - 1) {
-        return true;
+// Returns row in `_dir_tile` to use for stepping from [tile].
+static int tileGetParity(int tile)
+{
+    if (tileIsValid(tile)) {
+        return gTileFlags[tile] & TILE_FLAG_ODD_COLUMN;
     }
 
-    return false;
+    return (tile % gHexGridWidth) & 1;
 }
 
 // 0x4B1D80
@@ -1378,6 +1493,25 @@ static void tileRenderRoof(int fid, int x, int y, Rect* rect, int light)
 
 // 0x4B2944
 void tileRenderFloorsInRect(Rect* rect, int elevation)
+{
+    // CE: Lighting is always sampled from the current elevation, see
+    // `tileRenderFloor`.
+    if (elevation == gElevation && !artIsObjectTypeHidden(OBJ_TYPE_TILE)) {
+        tileRenderFloorsFromCache(rect, elevation);
+        return;
+    }
+
+    Rect windowRect;
+    windowRect.left = 0;
+    windowRect.top = 0;
+    windowRect.right = gTileWindowWidth - 1;
+    windowRect.bottom = gTileWindowHeight - 1;
+    tileRenderFloorsInRectToBuffer(rect, elevation, gTileWindowBuffer, gTileWindowPitch, &windowRect);
+}
+
+// CE: Draws floors into [dest] which holds [destRect] area of the window
+// (which might extend past the window itself).
+static void tileRenderFloorsInRectToBuffer(Rect* rect, int elevation, unsigned char* dest, int destPitch, Rect* destRect)
 {
     int minY;
     int maxX;
@@ -1406,6 +1540,16 @@ void tileRenderFloorsInRect(Rect* rect, int elevation)
         minY = gSquareGridHeight - 1;
     }
 
+    // CE: Chunks can extend past the map where original code would read squares
+    // out of bounds.
+    if (maxX >= gSquareGridWidth) {
+        maxX = gSquareGridWidth - 1;
+    }
+
+    if (maxY >= gSquareGridHeight) {
+        maxY = gSquareGridHeight - 1;
+    }
+
     lightGetAmbientIntensity();
 
     int baseSquareTile = gSquareGridWidth * minY;
@@ -1419,7 +1563,7 @@ void tileRenderFloorsInRect(Rect* rect, int elevation)
                 int tileScreenY;
                 squareTileToScreenXY(squareTile, &tileScreenX, &tileScreenY, elevation);
                 int fid = buildFid(OBJ_TYPE_TILE, frmId & 0xFFF, 0, 0, 0);
-                tileRenderFloor(fid, tileScreenX, tileScreenY, rect);
+                tileRenderFloor(fid, tileScreenX, tileScreenY, rect, dest, destPitch, destRect);
             }
         }
         baseSquareTile += gSquareGridWidth;
@@ -1537,7 +1681,7 @@ static void _draw_grid(int tile, int elevation, Rect* rect)
 }
 
 // 0x4B30C4
-static void tileRenderFloor(int fid, int x, int y, Rect* rect)
+static void tileRenderFloor(int fid, int x, int y, Rect* rect, unsigned char* dest, int destPitch, Rect* destRect)
 {
     if (artIsObjectTypeHidden(FID_TYPE(fid)) != 0) {
         return;
@@ -1565,23 +1709,24 @@ static void tileRenderFloor(int fid, int x, int y, Rect* rect)
     int savedX = x;
     int savedY = y;
 
-    if (left < 0) {
-        left = 0;
+    // CE: Clip to destination buffer rather than the window.
+    if (left < destRect->left) {
+        left = destRect->left;
     }
 
-    if (top < 0) {
-        top = 0;
+    if (top < destRect->top) {
+        top = destRect->top;
     }
 
-    if (left + width > gTileWindowWidth) {
-        width = gTileWindowWidth - left;
+    if (left + width > destRect->right + 1) {
+        width = destRect->right + 1 - left;
     }
 
-    if (top + height > gTileWindowHeight) {
-        height = gTileWindowHeight - top;
+    if (top + height > destRect->bottom + 1) {
+        height = destRect->bottom + 1 - top;
     }
 
-    if (x >= gTileWindowWidth || x > rect->right || y >= gTileWindowHeight || y > rect->bottom) goto out;
+    if (x > destRect->right || x > rect->right || y > destRect->bottom || y > rect->bottom) goto out;
 
     frameWidth = artGetWidth(art, 0, 0);
     frameHeight = artGetHeight(art, 0, 0);
@@ -1634,7 +1779,7 @@ static void tileRenderFloor(int fid, int x, int y, Rect* rect)
 
         if (v23 == 9) {
             unsigned char* buf = artGetFrameData(art, 0, 0);
-            _dark_trans_buf_to_buf(buf + frameWidth * v78 + v79, v77, v76, frameWidth, gTileWindowBuffer, x, y, gTileWindowPitch, _verticies[0].intensity);
+            _dark_trans_buf_to_buf(buf + frameWidth * v78 + v79, v77, v76, frameWidth, dest, x - destRect->left, y - destRect->top, destPitch, _verticies[0].intensity);
             goto out;
         }
 
@@ -1746,11 +1891,11 @@ static void tileRenderFloor(int fid, int x, int y, Rect* rect)
             }
         }
 
-        unsigned char* v66 = gTileWindowBuffer + gTileWindowPitch * y + x;
+        unsigned char* v66 = dest + destPitch * (y - destRect->top) + (x - destRect->left);
         unsigned char* v67 = artGetFrameData(art, 0, 0) + frameWidth * v78 + v79;
         int* v68 = &(_intensity_map[160 + 80 * v78]) + v79;
         int v86 = frameWidth - v77;
-        int v85 = gTileWindowPitch - v77;
+        int v85 = destPitch - v77;
         int v87 = 80 - v77;
 
         while (--v76 != -1) {
@@ -1773,6 +1918,226 @@ out:
     artUnlock(cacheEntry);
 }
 
+// CE: Returns map space position of the window's top-left corner. Map space
+// matches `gTileScreenX` and `gTileScreenY`.
+static void tileGetWorldOrigin(int* xPtr, int* yPtr)
+{
+    *xPtr = 24 * _tile_x + 16 * _tile_y - _tile_offx;
+    *yPtr = -6 * _tile_x + 12 * _tile_y - _tile_offy;
+}
+
+static void tileFloorChunkFree(TileFloorChunk* chunk)
+{
+    gTileFloorChunkSlots[chunk->elevation][chunk->row][chunk->column] = 0;
+    chunk->elevation = -1;
+}
+
+// Returns up to date floor chunk, rendering it (or its invalidated part) if
+// needed.
+static TileFloorChunk* tileFloorChunkGet(int elevation, int column, int row)
+{
+    TileFloorChunk* chunk;
+    int slot = gTileFloorChunkSlots[elevation][row][column];
+    if (slot != 0) {
+        chunk = &(gTileFloorChunks[slot - 1]);
+    } else {
+        // Take free or least recently used slot.
+        chunk = nullptr;
+        for (int index = 0; index < TILE_FLOOR_CHUNK_CACHE_CAPACITY; index++) {
+            TileFloorChunk* candidate = &(gTileFloorChunks[index]);
+            if (candidate->pixels == nullptr || candidate->elevation == -1) {
+                chunk = candidate;
+                slot = index + 1;
+                break;
+            }
+
+            if (chunk == nullptr || candidate->lastUsed < chunk->lastUsed) {
+                chunk = candidate;
+                slot = index + 1;
+            }
+        }
+
+        if (chunk->pixels == nullptr) {
+            chunk->pixels = (unsigned char*)internal_malloc(TILE_FLOOR_CHUNK_WIDTH * TILE_FLOOR_CHUNK_HEIGHT);
+            if (chunk->pixels == nullptr) {
+                return nullptr;
+            }
+        } else if (chunk->elevation != -1) {
+            tileFloorChunkFree(chunk);
+        }
+
+        chunk->elevation = elevation;
+        chunk->column = column;
+        chunk->row = row;
+        chunk->dirty = false;
+        tileFloorChunkInvalidateRect(chunk, nullptr);
+        gTileFloorChunkSlots[elevation][row][column] = static_cast<unsigned char>(slot);
+    }
+
+    if (chunk->dirty) {
+        tileFloorChunkRender(chunk, &(chunk->dirtyRect));
+        chunk->dirty = false;
+    }
+
+    chunk->lastUsed = ++gTileFloorChunksClock;
+
+    return chunk;
+}
+
+// Marks [rect] part of the chunk (in chunk coordinates) to be rendered again,
+// `nullptr` means entire chunk.
+static void tileFloorChunkInvalidateRect(TileFloorChunk* chunk, const Rect* rect)
+{
+    Rect chunkRect;
+    chunkRect.left = 0;
+    chunkRect.top = 0;
+    chunkRect.right = TILE_FLOOR_CHUNK_WIDTH - 1;
+    chunkRect.bottom = TILE_FLOOR_CHUNK_HEIGHT - 1;
+
+    if (rect == nullptr) {
+        rect = &chunkRect;
+    }
+
+    if (chunk->dirty) {
+        rectUnion(&(chunk->dirtyRect), rect, &(chunk->dirtyRect));
+    } else {
+        rectCopy(&(chunk->dirtyRect), rect);
+        chunk->dirty = true;
+    }
+}
+
+// Renders [rect] part of the chunk (in chunk coordinates).
+static void tileFloorChunkRender(TileFloorChunk* chunk, const Rect* rect)
+{
+    int worldOriginX;
+    int worldOriginY;
+    tileGetWorldOrigin(&worldOriginX, &worldOriginY);
+
+    // Window coordinates of the part being rendered.
+    Rect updatedRect;
+    rectCopy(&updatedRect, rect);
+    rectOffset(&updatedRect,
+        TILE_FLOOR_CHUNK_ORIGIN_X + chunk->column * TILE_FLOOR_CHUNK_WIDTH - worldOriginX,
+        TILE_FLOOR_CHUNK_ORIGIN_Y + chunk->row * TILE_FLOOR_CHUNK_HEIGHT - worldOriginY);
+
+    Rect selectionRect;
+    selectionRect.left = updatedRect.left - TILE_FLOOR_CHUNK_SELECTION_MARGIN_X;
+    selectionRect.top = updatedRect.top - TILE_FLOOR_CHUNK_SELECTION_MARGIN_Y;
+    selectionRect.right = updatedRect.right + TILE_FLOOR_CHUNK_SELECTION_MARGIN_X;
+    selectionRect.bottom = updatedRect.bottom + TILE_FLOOR_CHUNK_SELECTION_MARGIN_Y;
+
+    unsigned char* dest = chunk->pixels + TILE_FLOOR_CHUNK_WIDTH * rect->top + rect->left;
+    bufferFill(dest, rectGetWidth(rect), rectGetHeight(rect), TILE_FLOOR_CHUNK_WIDTH, 0);
+    tileRenderFloorsInRectToBuffer(&selectionRect, chunk->elevation, dest, TILE_FLOOR_CHUNK_WIDTH, &updatedRect);
+}
+
+// Copies floors in [rect] from floor chunks. Unlike floor rendering this
+// overwrites pixels where there are no floors, callers clear [rect] anyway.
+static void tileRenderFloorsFromCache(Rect* rect, int elevation)
+{
+    Rect windowRect;
+    windowRect.left = 0;
+    windowRect.top = 0;
+    windowRect.right = gTileWindowWidth - 1;
+    windowRect.bottom = gTileWindowHeight - 1;
+
+    Rect updatedRect;
+    if (rectIntersection(rect, &windowRect, &updatedRect) != 0) {
+        return;
+    }
+
+    int worldOriginX;
+    int worldOriginY;
+    tileGetWorldOrigin(&worldOriginX, &worldOriginY);
+
+    int minColumn = std::max((updatedRect.left + worldOriginX - TILE_FLOOR_CHUNK_ORIGIN_X) / TILE_FLOOR_CHUNK_WIDTH, 0);
+    int maxColumn = std::min((updatedRect.right + worldOriginX - TILE_FLOOR_CHUNK_ORIGIN_X) / TILE_FLOOR_CHUNK_WIDTH, TILE_FLOOR_CHUNK_COLUMNS - 1);
+    int minRow = std::max((updatedRect.top + worldOriginY - TILE_FLOOR_CHUNK_ORIGIN_Y) / TILE_FLOOR_CHUNK_HEIGHT, 0);
+    int maxRow = std::min((updatedRect.bottom + worldOriginY - TILE_FLOOR_CHUNK_ORIGIN_Y) / TILE_FLOOR_CHUNK_HEIGHT, TILE_FLOOR_CHUNK_ROWS - 1);
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int column = minColumn; column <= maxColumn; column++) {
+            Rect chunkRect;
+            chunkRect.left = TILE_FLOOR_CHUNK_ORIGIN_X + column * TILE_FLOOR_CHUNK_WIDTH - worldOriginX;
+            chunkRect.top = TILE_FLOOR_CHUNK_ORIGIN_Y + row * TILE_FLOOR_CHUNK_HEIGHT - worldOriginY;
+            chunkRect.right = chunkRect.left + TILE_FLOOR_CHUNK_WIDTH - 1;
+            chunkRect.bottom = chunkRect.top + TILE_FLOOR_CHUNK_HEIGHT - 1;
+
+            Rect copyRect;
+            if (rectIntersection(&updatedRect, &chunkRect, &copyRect) != 0) {
+                continue;
+            }
+
+            TileFloorChunk* chunk = tileFloorChunkGet(elevation, column, row);
+            if (chunk == nullptr) {
+                tileRenderFloorsInRectToBuffer(&copyRect, elevation, gTileWindowBuffer, gTileWindowPitch, &windowRect);
+                continue;
+            }
+
+            blitBufferToBuffer(chunk->pixels + TILE_FLOOR_CHUNK_WIDTH * (copyRect.top - chunkRect.top) + (copyRect.left - chunkRect.left),
+                copyRect.right - copyRect.left + 1,
+                copyRect.bottom - copyRect.top + 1,
+                TILE_FLOOR_CHUNK_WIDTH,
+                gTileWindowBuffer + gTileWindowPitch * copyRect.top + copyRect.left,
+                gTileWindowPitch);
+        }
+    }
+}
+
+// CE: Drops all floor chunks.
+void tileInvalidateFloorCache()
+{
+    for (int index = 0; index < TILE_FLOOR_CHUNK_CACHE_CAPACITY; index++) {
+        TileFloorChunk* chunk = &(gTileFloorChunks[index]);
+        if (chunk->pixels != nullptr && chunk->elevation != -1) {
+            tileFloorChunkFree(chunk);
+        }
+    }
+}
+
+// CE: Marks floors affected by light intensity of [tile] to be rendered again.
+void tileInvalidateFloorCacheAroundTile(int tile, int elevation)
+{
+    if (!tileIsValid(tile) || !elevationIsValid(elevation)) {
+        return;
+    }
+
+    // Map space area affected by the tile.
+    Rect affectedRect;
+    affectedRect.left = gTileScreenX[tile] - TILE_FLOOR_LIGHT_MARGIN_X;
+    affectedRect.top = gTileScreenY[tile] - TILE_FLOOR_LIGHT_MARGIN_Y;
+    affectedRect.right = gTileScreenX[tile] + TILE_FLOOR_LIGHT_MARGIN_X;
+    affectedRect.bottom = gTileScreenY[tile] + TILE_FLOOR_LIGHT_MARGIN_Y;
+
+    int minColumn = std::max((affectedRect.left - TILE_FLOOR_CHUNK_ORIGIN_X) / TILE_FLOOR_CHUNK_WIDTH, 0);
+    int maxColumn = std::min((affectedRect.right - TILE_FLOOR_CHUNK_ORIGIN_X) / TILE_FLOOR_CHUNK_WIDTH, TILE_FLOOR_CHUNK_COLUMNS - 1);
+    int minRow = std::max((affectedRect.top - TILE_FLOOR_CHUNK_ORIGIN_Y) / TILE_FLOOR_CHUNK_HEIGHT, 0);
+    int maxRow = std::min((affectedRect.bottom - TILE_FLOOR_CHUNK_ORIGIN_Y) / TILE_FLOOR_CHUNK_HEIGHT, TILE_FLOOR_CHUNK_ROWS - 1);
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int column = minColumn; column <= maxColumn; column++) {
+            int slot = gTileFloorChunkSlots[elevation][row][column];
+            if (slot == 0) {
+                continue;
+            }
+
+            Rect chunkRect;
+            chunkRect.left = TILE_FLOOR_CHUNK_ORIGIN_X + column * TILE_FLOOR_CHUNK_WIDTH;
+            chunkRect.top = TILE_FLOOR_CHUNK_ORIGIN_Y + row * TILE_FLOOR_CHUNK_HEIGHT;
+            chunkRect.right = chunkRect.left + TILE_FLOOR_CHUNK_WIDTH - 1;
+            chunkRect.bottom = chunkRect.top + TILE_FLOOR_CHUNK_HEIGHT - 1;
+
+            Rect invalidatedRect;
+            if (rectIntersection(&affectedRect, &chunkRect, &invalidatedRect) != 0) {
+                continue;
+            }
+
+            rectOffset(&invalidatedRect, -chunkRect.left, -chunkRect.top);
+            tileFloorChunkInvalidateRect(&(gTileFloorChunks[slot - 1]), &invalidatedRect);
+        }
+    }
+}
+
 // 0x4B372C
 static int _tile_make_line(int from, int to, int* tiles, int tilesCapacity)
 {
@@ -96,6 +96,8 @@ void traitsReset()
     for (int index = 0; index < TRAITS_MAX_SELECTED_COUNT; index++) {
         gSelectedTraits[index] = -1;
     }
+
+    statsInvalidateCache();
 }
 
 // 0x4B3AF8
@@ -110,7 +112,13 @@ void traitsExit()
 // 0x4B3B08
 int traitsLoad(File* stream)
 {
-    return fileReadInt32List(stream, gSelectedTraits, TRAITS_MAX_SELECTED_COUNT);
+    if (fileReadInt32List(stream, gSelectedTraits, TRAITS_MAX_SELECTED_COUNT) == -1) {
+        return -1;
+    }
+
+    statsInvalidateCache();
+
+    return 0;
 }
 
 // Saves trait system state to save game.
@@ -128,6 +136,8 @@ void traitsSetSelected(int trait1, int trait2)
 {
     gSelectedTraits[0] = trait1;
     gSelectedTraits[1] = trait2;
+
+    statsInvalidateCache();
 }
 
 // Returns selected traits.
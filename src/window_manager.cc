@@ -902,7 +902,10 @@ void _GNW_win_refresh(Window* window, Rect* rect, unsigned char* dest)
                 while (clipRect != nullptr) {
                     int width = clipRect->rect.right - clipRect->rect.left + 1;
                     int height = clipRect->rect.bottom - clipRect->rect.top + 1;
-                    unsigned char* buf = (unsigned char*)internal_malloc(width * height);
+                    // CE: Use frame scratch instead of allocating a block per
+                    // rectangle.
+                    unsigned char* frameBuf = (unsigned char*)memoryFrameAlloc(width * height);
+                    unsigned char* buf = frameBuf != nullptr ? frameBuf : (unsigned char*)internal_malloc(width * height);
                     if (buf != nullptr) {
                         bufferFill(buf, width, height, width, _bk_color);
                         if (dest_pitch != 0) {
@@ -926,7 +929,9 @@ void _GNW_win_refresh(Window* window, Rect* rect, unsigned char* dest)
                             }
                         }
 
-                        internal_free(buf);
+                        if (buf != frameBuf) {
+                            internal_free(buf);
+                        }
                     }
                     clipRect = clipRect->next;
                 }
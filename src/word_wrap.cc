@@ -4,12 +4,73 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <string>
+
 #include "text_font.h"
 
 namespace fallout {
 
-// 0x4BC6F0
+// CE: Number of wrapped strings cached at the same time.
+#define WORD_WRAP_CACHE_SIZE (128)
+
+// CE: Result of wrapping a string with given width and font.
+typedef struct WordWrapCacheEntry {
+    bool valid;
+    std::string string;
+    int width;
+    int font;
+    int rc;
+    short breakpointsLength;
+    short breakpoints[WORD_WRAP_MAX_COUNT];
+} WordWrapCacheEntry;
+
+static int wordWrapImpl(const char* string, int width, short* breakpoints, short* breakpointsLengthPtr);
+
+static WordWrapCacheEntry gWordWrapCache[WORD_WRAP_CACHE_SIZE];
+
+// CE: Dialogs, holodisks and descriptions are re-wrapped on every redraw, so
+// results are cached by string contents, width and current font (font
+// metrics never change once loaded).
 int wordWrap(const char* string, int width, short* breakpoints, short* breakpointsLengthPtr)
+{
+    int font = fontGetCurrent();
+
+    // FNV-1a.
+    unsigned int hash = 2166136261u;
+    size_t length = 0;
+    for (const char* pch = string; *pch != '\0'; pch++) {
+        hash = (hash ^ static_cast<unsigned char>(*pch)) * 16777619u;
+        length++;
+    }
+    hash = (hash ^ static_cast<unsigned int>(width)) * 16777619u;
+    hash = (hash ^ static_cast<unsigned int>(font)) * 16777619u;
+
+    WordWrapCacheEntry* entry = &(gWordWrapCache[hash % WORD_WRAP_CACHE_SIZE]);
+    if (entry->valid
+        && entry->width == width
+        && entry->font == font
+        && entry->string.size() == length
+        && memcmp(entry->string.data(), string, length) == 0) {
+        memcpy(breakpoints, entry->breakpoints, sizeof(entry->breakpoints));
+        *breakpointsLengthPtr = entry->breakpointsLength;
+        return entry->rc;
+    }
+
+    int rc = wordWrapImpl(string, width, breakpoints, breakpointsLengthPtr);
+
+    entry->valid = true;
+    entry->string.assign(string, length);
+    entry->width = width;
+    entry->font = font;
+    entry->rc = rc;
+    entry->breakpointsLength = *breakpointsLengthPtr;
+    memcpy(entry->breakpoints, breakpoints, sizeof(entry->breakpoints));
+
+    return rc;
+}
+
+// 0x4BC6F0
+static int wordWrapImpl(const char* string, int width, short* breakpoints, short* breakpointsLengthPtr)
 {
     breakpoints[0] = 0;
     *breakpointsLengthPtr = 1;
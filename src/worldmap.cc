@@ -4,6 +4,7 @@
 #include <ctype.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <algorithm>
@@ -541,9 +542,12 @@ static int wmInterfaceRefresh();
 static void wmInterfaceRefreshDate(bool shouldRefreshWindow);
 static int wmMatchWorldPosToArea(int x, int y, int* areaIdxPtr);
 static int wmInterfaceDrawCircleOverlay(CityInfo* cityInfo, CitySizeDescription* citySizeInfo, unsigned char* buffer, int x, int y);
-static int wmInterfaceDrawCircleOverlaySafe(CityInfo* city, CitySizeDescription* citySizeDescription, unsigned char* dest, int x, int y);
+static int wmInterfaceDrawCircleOverlaySafe(CityInfo* city, CitySizeDescription* citySizeDescription, unsigned char* dest, int x, int y, const Rect* clip);
 static void wmInterfaceDrawSubTileRectFogged(unsigned char* dest, int width, int height, int pitch);
-static int wmInterfaceDrawSubTileList(TileInfo* tileInfo, int column, int row, int x, int y, int a6);
+static int wmInterfaceRefreshView();
+static int wmInterfaceDrawView(int x, int y, int width, int height);
+static void wmInterfaceInvalidateView();
+static void wmInterfaceInvalidateSubTile(int tile, int subtileX, int subtileY);
 static int wmDrawCursorStopped();
 static bool wmCursorIsVisible();
 static int wmGetAreaName(CityInfo* city, char* name);
@@ -688,6 +692,19 @@ static unsigned char* wmBkWinBuf = nullptr;
 static unsigned char* wmOverlayOffscreenBuf = nullptr;
 #define WM_OVERLAY_BUFFER_SIZE (200)
 
+// CE: Composed world map view (tiles, city circles and fog) as of the last
+// refresh, without cursors. Scrolling reuses the part that is still visible,
+// and fog changes redraw only affected subtiles.
+static unsigned char* wmViewCacheBuf = nullptr;
+static bool wmViewCacheValid = false;
+static int wmViewCacheWorldOffsetX = 0;
+static int wmViewCacheWorldOffsetY = 0;
+
+// CE: Area of the world map (in world coordinates) which changed since the
+// last refresh.
+static bool wmViewCacheHasDirtyRect = false;
+static Rect wmViewCacheDirtyRect;
+
 // 0x51DE2C
 static int wmWorldOffsetX = 0;
 
@@ -1258,6 +1275,7 @@ int wmWorldMap_load(File* stream)
         if (fileReadInt32(stream, &(encounterTableEntry->counter)) == -1) return -1;
     }
 
+    wmInterfaceInvalidateView();
     wmInterfaceCenterOnParty();
 
     return 0;
@@ -3112,6 +3130,7 @@ static int wmWorldMapFunc(int a1)
 
                         city->state = CITY_STATE_KNOWN;
                         city->visitedState = 1;
+                        wmInterfaceInvalidateView();
 
                         wmGenData.currentAreaId = CITY_CAR_OUT_OF_GAS;
                     } else {
@@ -3475,6 +3494,7 @@ static int wmRndEncounterOccurred()
             CityInfo* city = &(wmAreaInfoList[areaIdx]);
             if (city->lockState != LOCK_STATE_LOCKED) {
                 city->state = CITY_STATE_KNOWN;
+                wmInterfaceInvalidateView();
             }
         }
     }
@@ -4310,6 +4330,23 @@ static void wmPartyInitWalking(int x, int y)
     wmGenData.currentAreaId = -1;
     wmGenData.isWalking = true;
 
+    // CE: When heading to a location which is entered directly (not via
+    // town map), start loading its map while the party travels.
+    int areaIdx;
+    wmMatchWorldPosToArea(x, y, &areaIdx);
+    if (areaIdx != -1) {
+        CityInfo* city = &(wmAreaInfoList[areaIdx]);
+        if (city->visitedState != 2 || city->mapFid == -1) {
+            for (int index = 0; index < city->entrancesLength; index++) {
+                EntranceInfo* entrance = &(city->entrances[index]);
+                if (entrance->state != 0) {
+                    mapPreload(entrance->map);
+                    break;
+                }
+            }
+        }
+    }
+
     int dx = abs(x - wmGenData.worldPosX);
     int dy = abs(y - wmGenData.worldPosY);
 
@@ -4544,6 +4581,13 @@ static int wmInterfaceInit()
         return -1;
     }
 
+    wmViewCacheBuf = (unsigned char*)internal_malloc(WM_VIEW_WIDTH * WM_VIEW_HEIGHT);
+    if (wmViewCacheBuf == nullptr) {
+        return -1;
+    }
+
+    wmInterfaceInvalidateView();
+
     blitBufferToBuffer(_backgroundFrmImage.getData(),
         _backgroundFrmImage.getWidth(),
         _backgroundFrmImage.getHeight(),
@@ -4877,6 +4921,13 @@ static int wmInterfaceExit()
         wmOverlayOffscreenBuf = nullptr;
     }
 
+    if (wmViewCacheBuf != nullptr) {
+        internal_free(wmViewCacheBuf);
+        wmViewCacheBuf = nullptr;
+    }
+
+    wmViewCacheValid = false;
+
     wmInterfaceWasInitialized = 0;
 
     scriptsEnable();
@@ -5107,6 +5158,7 @@ static int wmMarkSubTileOffsetVisitedFunc(int tile, int subtileX, int subtileY,
     subtileInfo = &(tileInfo->subtiles[actualSubtileY][actualSubtileX]);
     if (subtileState != SUBTILE_STATE_KNOWN || subtileInfo->state == SUBTILE_STATE_UNKNOWN) {
         subtileInfo->state = subtileState;
+        wmInterfaceInvalidateSubTile(actualTile, actualSubtileX, actualSubtileY);
     }
 
     return 0;
@@ -5147,6 +5199,7 @@ int wmSubTileMarkRadiusVisited(int x, int y, int radius)
 
     subtile = &(wmTileInfoList[tile].subtiles[subtileY][subtileX]);
     subtile->state = SUBTILE_STATE_VISITED;
+    wmInterfaceInvalidateSubTile(tile, subtileX, subtileY);
 
     switch (subtile->fill) {
     case SUBTILE_FILL_S:
@@ -5213,65 +5266,136 @@ static int wmInterfaceRefresh()
         return 0;
     }
 
-    int v17 = wmWorldOffsetX % WM_TILE_WIDTH;
-    int v18 = wmWorldOffsetY % WM_TILE_HEIGHT;
-    int v20 = WM_TILE_HEIGHT - v18;
-    int v21 = WM_TILE_WIDTH * v18;
-    int v19 = WM_TILE_WIDTH - v17;
+    if (wmInterfaceRefreshView() == -1) {
+        return -1;
+    }
 
-    // Render tiles.
-    int y = 0;
-    int x = 0;
-    int v0 = wmWorldOffsetY / WM_TILE_HEIGHT * wmNumHorizontalTiles + wmWorldOffsetX / WM_TILE_WIDTH % wmNumHorizontalTiles;
-    while (y < WM_VIEW_HEIGHT) {
-        x = 0;
-        int v23 = 0;
-        int height;
-        while (x < WM_VIEW_WIDTH) {
-            if (wmTileGrabArt(v0) == -1) {
-                return -1;
-            }
+    wmDrawCursorStopped();
+
+    wmRefreshInterfaceOverlay(true);
+
+    return 0;
+}
+
+// CE: Renders world map view into window buffer reusing as much as possible
+// from the previous refresh.
+static int wmInterfaceRefreshView()
+{
+    unsigned char* view = wmBkWinBuf + WM_WINDOW_WIDTH * WM_VIEW_Y + WM_VIEW_X;
+
+    int dx = wmWorldOffsetX - wmViewCacheWorldOffsetX;
+    int dy = wmWorldOffsetY - wmViewCacheWorldOffsetY;
 
-            int width = WM_TILE_WIDTH;
+    if (!wmViewCacheValid || abs(dx) >= WM_VIEW_WIDTH || abs(dy) >= WM_VIEW_HEIGHT) {
+        if (wmInterfaceDrawView(0, 0, WM_VIEW_WIDTH, WM_VIEW_HEIGHT) == -1) {
+            return -1;
+        }
+    } else {
+        // Shift part of the previous view which is still visible.
+        int width = WM_VIEW_WIDTH - abs(dx);
+        int height = WM_VIEW_HEIGHT - abs(dy);
+        int srcX = std::max(dx, 0);
+        int srcY = std::max(dy, 0);
+        int destX = std::max(-dx, 0);
+        int destY = std::max(-dy, 0);
+        blitBufferToBuffer(wmViewCacheBuf + WM_VIEW_WIDTH * srcY + srcX,
+            width,
+            height,
+            WM_VIEW_WIDTH,
+            view + WM_WINDOW_WIDTH * destY + destX,
+            WM_WINDOW_WIDTH);
 
-            int srcX = 0;
-            if (x == 0) {
-                srcX = v17;
-                width = v19;
+        // Draw exposed rows.
+        if (dy > 0) {
+            if (wmInterfaceDrawView(0, height, WM_VIEW_WIDTH, dy) == -1) {
+                return -1;
             }
+        } else if (dy < 0) {
+            if (wmInterfaceDrawView(0, 0, WM_VIEW_WIDTH, -dy) == -1) {
+                return -1;
+            }
+        }
 
-            if (width + x > WM_VIEW_WIDTH) {
-                width = WM_VIEW_WIDTH - x;
+        // Draw exposed columns (between exposed rows).
+        if (dx > 0) {
+            if (wmInterfaceDrawView(width, destY, dx, height) == -1) {
+                return -1;
+            }
+        } else if (dx < 0) {
+            if (wmInterfaceDrawView(0, destY, -dx, height) == -1) {
+                return -1;
             }
+        }
 
-            height = WM_TILE_HEIGHT;
-            if (y == 0) {
-                height = v20;
-                srcX += v21;
+        // Redraw subtiles which fog state has changed.
+        if (wmViewCacheHasDirtyRect) {
+            int left = std::max(wmViewCacheDirtyRect.left - wmWorldOffsetX, 0);
+            int top = std::max(wmViewCacheDirtyRect.top - wmWorldOffsetY, 0);
+            int right = std::min(wmViewCacheDirtyRect.right - wmWorldOffsetX + 1, WM_VIEW_WIDTH);
+            int bottom = std::min(wmViewCacheDirtyRect.bottom - wmWorldOffsetY + 1, WM_VIEW_HEIGHT);
+            if (left < right && top < bottom) {
+                if (wmInterfaceDrawView(left, top, right - left, bottom - top) == -1) {
+                    return -1;
+                }
             }
+        }
+    }
+
+    blitBufferToBuffer(view,
+        WM_VIEW_WIDTH,
+        WM_VIEW_HEIGHT,
+        WM_WINDOW_WIDTH,
+        wmViewCacheBuf,
+        WM_VIEW_WIDTH);
 
-            if (height + y > WM_VIEW_HEIGHT) {
-                height = WM_VIEW_HEIGHT - y;
+    wmViewCacheValid = true;
+    wmViewCacheWorldOffsetX = wmWorldOffsetX;
+    wmViewCacheWorldOffsetY = wmWorldOffsetY;
+    wmViewCacheHasDirtyRect = false;
+
+    return 0;
+}
+
+// CE: Renders tiles, city circles and fog into specified rectangle of world
+// map view (in view coordinates).
+static int wmInterfaceDrawView(int x, int y, int width, int height)
+{
+    int worldLeft = wmWorldOffsetX + x;
+    int worldTop = wmWorldOffsetY + y;
+    int worldRight = worldLeft + width;
+    int worldBottom = worldTop + height;
+    int numVerticalTiles = wmMaxTileNum / wmNumHorizontalTiles;
+
+    // Render tiles.
+    for (int tileY = worldTop / WM_TILE_HEIGHT; tileY * WM_TILE_HEIGHT < worldBottom && tileY < numVerticalTiles; tileY++) {
+        for (int tileX = worldLeft / WM_TILE_WIDTH; tileX * WM_TILE_WIDTH < worldRight && tileX < wmNumHorizontalTiles; tileX++) {
+            int tileIdx = tileY * wmNumHorizontalTiles + tileX;
+            if (wmTileGrabArt(tileIdx) == -1) {
+                return -1;
             }
 
-            TileInfo* tileInfo = &(wmTileInfoList[v0]);
-            blitBufferToBuffer(tileInfo->data + srcX,
-                width,
-                height,
+            int left = std::max(worldLeft, tileX * WM_TILE_WIDTH);
+            int top = std::max(worldTop, tileY * WM_TILE_HEIGHT);
+            int right = std::min(worldRight, (tileX + 1) * WM_TILE_WIDTH);
+            int bottom = std::min(worldBottom, (tileY + 1) * WM_TILE_HEIGHT);
+
+            TileInfo* tileInfo = &(wmTileInfoList[tileIdx]);
+            blitBufferToBuffer(tileInfo->data + WM_TILE_WIDTH * (top - tileY * WM_TILE_HEIGHT) + left - tileX * WM_TILE_WIDTH,
+                right - left,
+                bottom - top,
                 WM_TILE_WIDTH,
-                wmBkWinBuf + WM_WINDOW_WIDTH * (y + WM_VIEW_Y) + WM_VIEW_X + x,
+                wmBkWinBuf + WM_WINDOW_WIDTH * (WM_VIEW_Y + top - wmWorldOffsetY) + WM_VIEW_X + left - wmWorldOffsetX,
                 WM_WINDOW_WIDTH);
-            v0++;
-
-            x += width;
-            v23++;
         }
-
-        v0 += wmNumHorizontalTiles - v23;
-        y += height;
     }
 
     // Render cities.
+    Rect clip;
+    clip.left = WM_VIEW_X + x;
+    clip.top = WM_VIEW_Y + y;
+    clip.right = clip.left + width - 1;
+    clip.bottom = clip.top + height - 1;
+
     for (int index = 0; index < wmMaxAreaNum; index++) {
         CityInfo* cityInfo = &(wmAreaInfoList[index]);
         if (cityInfo->state != CITY_STATE_UNKNOWN) {
@@ -5279,81 +5403,62 @@ static int wmInterfaceRefresh()
             int cityX = cityInfo->x - wmWorldOffsetX;
             int cityY = cityInfo->y - wmWorldOffsetY;
             // CE: Use safe overlay drawing with proper bounds checking instead of hardcoded limits
-            wmInterfaceDrawCircleOverlaySafe(cityInfo, citySizeDescription, wmBkWinBuf, cityX, cityY);
+            wmInterfaceDrawCircleOverlaySafe(cityInfo, citySizeDescription, wmBkWinBuf, cityX, cityY, &clip);
         }
     }
 
     // Hide unknown subtiles, dim unvisited.
-    int v25 = wmWorldOffsetX / WM_TILE_WIDTH % wmNumHorizontalTiles + wmWorldOffsetY / WM_TILE_HEIGHT * wmNumHorizontalTiles;
-    int v30 = 0;
-    while (v30 < WM_VIEW_HEIGHT) {
-        int v24 = 0;
-        int v33 = 0;
-        int v29;
-        while (v33 < WM_VIEW_WIDTH) {
-            int v31 = WM_TILE_WIDTH;
-            if (v33 == 0) {
-                v31 = WM_TILE_WIDTH - v17;
-            }
-
-            if (v33 + v31 > WM_VIEW_WIDTH) {
-                v31 = WM_VIEW_WIDTH - v33;
-            }
-
-            v29 = WM_TILE_HEIGHT;
-            if (v30 == 0) {
-                v29 -= v18;
-            }
-
-            if (v30 + v29 > WM_VIEW_HEIGHT) {
-                v29 = WM_VIEW_HEIGHT - v30;
-            }
-
-            int v32;
-            if (v30 != 0) {
-                v32 = WM_VIEW_Y;
-            } else {
-                v32 = WM_VIEW_Y - v18;
+    for (int row = worldTop / WM_SUBTILE_SIZE; row * WM_SUBTILE_SIZE < worldBottom && row < numVerticalTiles * SUBTILE_GRID_HEIGHT; row++) {
+        for (int column = worldLeft / WM_SUBTILE_SIZE; column * WM_SUBTILE_SIZE < worldRight && column < wmNumHorizontalTiles * SUBTILE_GRID_WIDTH; column++) {
+            int tileIdx = row / SUBTILE_GRID_HEIGHT * wmNumHorizontalTiles + column / SUBTILE_GRID_WIDTH;
+            SubtileInfo* subtileInfo = &(wmTileInfoList[tileIdx].subtiles[row % SUBTILE_GRID_HEIGHT][column % SUBTILE_GRID_WIDTH]);
+            if (subtileInfo->state == SUBTILE_STATE_VISITED) {
+                continue;
             }
 
-            int v13 = 0;
-            int v34 = v30 + v32;
+            int left = std::max(worldLeft, column * WM_SUBTILE_SIZE);
+            int top = std::max(worldTop, row * WM_SUBTILE_SIZE);
+            int right = std::min(worldRight, (column + 1) * WM_SUBTILE_SIZE);
+            int bottom = std::min(worldBottom, (row + 1) * WM_SUBTILE_SIZE);
 
-            for (int row = 0; row < SUBTILE_GRID_HEIGHT; row++) {
-                int v35;
-                if (v33 != 0) {
-                    v35 = WM_VIEW_X;
-                } else {
-                    v35 = WM_VIEW_X - v17;
-                }
-
-                int v15 = v33 + v35;
-                for (int column = 0; column < SUBTILE_GRID_WIDTH; column++) {
-                    TileInfo* tileInfo = &(wmTileInfoList[v25]);
-                    wmInterfaceDrawSubTileList(tileInfo, column, row, v15, v34, 1);
-
-                    v15 += WM_SUBTILE_SIZE;
-                    v35 += WM_SUBTILE_SIZE;
-                }
-
-                v32 += WM_SUBTILE_SIZE;
-                v34 += WM_SUBTILE_SIZE;
+            unsigned char* dest = wmBkWinBuf + WM_WINDOW_WIDTH * (WM_VIEW_Y + top - wmWorldOffsetY) + WM_VIEW_X + left - wmWorldOffsetX;
+            switch (subtileInfo->state) {
+            case SUBTILE_STATE_UNKNOWN:
+                bufferFill(dest, right - left, bottom - top, WM_WINDOW_WIDTH, _colorTable[0]);
+                break;
+            case SUBTILE_STATE_KNOWN:
+                wmInterfaceDrawSubTileRectFogged(dest, right - left, bottom - top, WM_WINDOW_WIDTH);
+                break;
             }
-
-            v25++;
-            v24++;
-            v33 += v31;
         }
-
-        v25 += wmNumHorizontalTiles - v24;
-        v30 += v29;
     }
 
-    wmDrawCursorStopped();
+    return 0;
+}
 
-    wmRefreshInterfaceOverlay(true);
+// CE: Forces entire world map view to be rendered from scratch on the next
+// refresh. Used when cities are changed.
+static void wmInterfaceInvalidateView()
+{
+    wmViewCacheValid = false;
+    wmViewCacheHasDirtyRect = false;
+}
 
-    return 0;
+// CE: Marks subtile to be rendered again on the next refresh.
+static void wmInterfaceInvalidateSubTile(int tile, int subtileX, int subtileY)
+{
+    Rect rect;
+    rect.left = tile % wmNumHorizontalTiles * WM_TILE_WIDTH + subtileX * WM_SUBTILE_SIZE;
+    rect.top = tile / wmNumHorizontalTiles * WM_TILE_HEIGHT + subtileY * WM_SUBTILE_SIZE;
+    rect.right = rect.left + WM_SUBTILE_SIZE - 1;
+    rect.bottom = rect.top + WM_SUBTILE_SIZE - 1;
+
+    if (wmViewCacheHasDirtyRect) {
+        rectUnion(&wmViewCacheDirtyRect, &rect, &wmViewCacheDirtyRect);
+    } else {
+        wmViewCacheDirtyRect = rect;
+        wmViewCacheHasDirtyRect = true;
+    }
 }
 
 // 0x4C3C9C
@@ -5434,7 +5539,7 @@ static int wmMatchWorldPosToArea(int x, int y, int* areaIdxPtr)
 }
 
 // CE: Safe city overlay drawing with proper bounds checking
-static int wmInterfaceDrawCircleOverlaySafe(CityInfo* city, CitySizeDescription* citySizeDescription, unsigned char* dest, int xArg, int yArg)
+static int wmInterfaceDrawCircleOverlaySafe(CityInfo* city, CitySizeDescription* citySizeDescription, unsigned char* dest, int xArg, int yArg, const Rect* clip)
 {
     MessageListItem messageListItem;
     char name[CITY_NAME_SIZE];
@@ -5463,11 +5568,11 @@ static int wmInterfaceDrawCircleOverlaySafe(CityInfo* city, CitySizeDescription*
     int contentActualWidth = contentMaxXRel - contentMinXRel;
     int contentActualHeight = circleHeight + spacing + textHeight;
 
-    // Viewport boundaries
-    int viewportLeft = WM_VIEW_X;
-    int viewportTop = WM_VIEW_Y;
-    int viewportRight = WM_VIEW_X + WM_VIEW_WIDTH;
-    int viewportBottom = WM_VIEW_Y + WM_VIEW_HEIGHT;
+    // Viewport boundaries (CE: limited to the area being redrawn)
+    int viewportLeft = clip->left;
+    int viewportTop = clip->top;
+    int viewportRight = clip->right + 1;
+    int viewportBottom = clip->bottom + 1;
 
     // Overall screen position for the content bounding box's top-left
     int screenContentBoxX = xArg + contentMinXRel;
@@ -5633,53 +5738,6 @@ static void wmInterfaceDrawSubTileRectFogged(unsigned char* dest, int width, int
     }
 }
 
-// 0x4C40E4
-static int wmInterfaceDrawSubTileList(TileInfo* tileInfo, int column, int row, int x, int y, int a6)
-{
-    SubtileInfo* subtileInfo = &(tileInfo->subtiles[row][column]);
-
-    int destY = y;
-    int destX = x;
-
-    int height = WM_SUBTILE_SIZE;
-    if (y < WM_VIEW_Y) {
-        if (y < 0) {
-            height = y + 29;
-        } else {
-            height = WM_SUBTILE_SIZE - (WM_VIEW_Y - y);
-        }
-        destY = WM_VIEW_Y;
-    }
-
-    if (height + y > WM_VIEW_Y + WM_VIEW_HEIGHT) {
-        height -= height + y - (WM_VIEW_Y + WM_VIEW_HEIGHT);
-    }
-
-    int width = WM_SUBTILE_SIZE * a6;
-    if (x < WM_VIEW_X) {
-        destX = WM_VIEW_X;
-        width -= WM_VIEW_X - x;
-    }
-
-    if (width + x > WM_VIEW_X + WM_VIEW_WIDTH) {
-        width -= width + x - (WM_VIEW_X + WM_VIEW_WIDTH);
-    }
-
-    if (width > 0 && height > 0) {
-        unsigned char* dest = wmBkWinBuf + WM_WINDOW_WIDTH * destY + destX;
-        switch (subtileInfo->state) {
-        case SUBTILE_STATE_UNKNOWN:
-            bufferFill(dest, width, height, WM_WINDOW_WIDTH, _colorTable[0]);
-            break;
-        case SUBTILE_STATE_KNOWN:
-            wmInterfaceDrawSubTileRectFogged(dest, width, height, WM_WINDOW_WIDTH);
-            break;
-        }
-    }
-
-    return 0;
-}
-
 // 0x4C41EC
 static int wmDrawCursorStopped()
 {
@@ -5931,6 +5989,9 @@ bool wmAreaMarkVisitedState(int areaIdx, int state)
         city->visitedState = 1;
     }
 
+    // CE: City name depends on visited state.
+    wmInterfaceInvalidateView();
+
     return true;
 }
 
@@ -5944,6 +6005,7 @@ bool wmAreaSetVisibleState(int areaIdx, int state, bool force)
     CityInfo* city = &(wmAreaInfoList[areaIdx]);
     if (city->lockState != LOCK_STATE_LOCKED || force) {
         city->state = state;
+        wmInterfaceInvalidateView();
         return true;
     }
 
@@ -5969,6 +6031,8 @@ int wmAreaSetWorldPos(int areaIdx, int x, int y)
     city->x = x;
     city->y = y;
 
+    wmInterfaceInvalidateView();
+
     return 0;
 }
 
@@ -6013,6 +6077,8 @@ static void wmMarkAllSubTiles(int state)
             }
         }
     }
+
+    wmInterfaceInvalidateView();
 }
 
 // 0x4C4850
@@ -6331,6 +6397,7 @@ int wmCarGiveToParty()
     CityInfo* city = &(wmAreaInfoList[CITY_CAR_OUT_OF_GAS]);
     city->state = CITY_STATE_UNKNOWN;
     city->visitedState = 0;
+    wmInterfaceInvalidateView();
 
     return 0;
 }
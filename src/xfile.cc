@@ -34,6 +34,9 @@ static int xbaseMakeDirectory(const char* path);
 static void xbaseCloseAll();
 static void xbaseExitHandler(void);
 static bool xlistEnumerateHandler(XListEnumerationContext* context);
+static size_t xmemoryRead(void* ptr, size_t size, size_t count, XMemoryFile* stream);
+static char* xmemoryReadString(char* string, int size, XMemoryFile* stream);
+static int xmemorySeek(XMemoryFile* stream, long offset, int origin);
 
 // 0x6B24D0
 static XBase* gXbaseHead;
@@ -55,6 +58,10 @@ int xfileClose(XFile* stream)
     case XFILE_TYPE_GZFILE:
         rc = gzclose(stream->gzfile);
         break;
+    case XFILE_TYPE_MEMORY:
+        free(stream->memory.data);
+        rc = 0;
+        break;
     default:
         rc = fclose(stream->file);
         break;
@@ -158,6 +165,25 @@ XFile* xfileOpen(const char* filePath, const char* mode)
     return stream;
 }
 
+// CE: Opens read-only stream over [data] which must be allocated with
+// `malloc`. The stream takes ownership of [data] and frees it on close.
+XFile* xfileOpenMemory(void* data, long size)
+{
+    XFile* stream = (XFile*)malloc(sizeof(*stream));
+    if (stream == nullptr) {
+        return nullptr;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+
+    stream->type = XFILE_TYPE_MEMORY;
+    stream->memory.data = (unsigned char*)data;
+    stream->memory.size = size;
+    stream->memory.position = 0;
+
+    return stream;
+}
+
 // 0x4DF11C
 int xfilePrintFormatted(XFile* stream, const char* format, ...)
 {
@@ -190,6 +216,9 @@ int xfilePrintFormattedArgs(XFile* stream, const char* format, va_list args)
     case XFILE_TYPE_GZFILE:
         rc = gzvprintf(stream->gzfile, format, args);
         break;
+    case XFILE_TYPE_MEMORY:
+        rc = -1;
+        break;
     default:
         rc = vfprintf(stream->file, format, args);
         break;
@@ -212,6 +241,13 @@ int xfileReadChar(XFile* stream)
     case XFILE_TYPE_GZFILE:
         ch = gzgetc(stream->gzfile);
         break;
+    case XFILE_TYPE_MEMORY:
+        if (stream->memory.position < stream->memory.size) {
+            ch = stream->memory.data[stream->memory.position++];
+        } else {
+            ch = -1;
+        }
+        break;
     default:
         ch = fgetc(stream->file);
         break;
@@ -236,6 +272,9 @@ char* xfileReadString(char* string, int size, XFile* stream)
     case XFILE_TYPE_GZFILE:
         result = compat_gzgets(stream->gzfile, string, size);
         break;
+    case XFILE_TYPE_MEMORY:
+        result = xmemoryReadString(string, size, &(stream->memory));
+        break;
     default:
         result = compat_fgets(string, size, stream->file);
         break;
@@ -258,6 +297,9 @@ int xfileWriteChar(int ch, XFile* stream)
     case XFILE_TYPE_GZFILE:
         rc = gzputc(stream->gzfile, ch);
         break;
+    case XFILE_TYPE_MEMORY:
+        rc = -1;
+        break;
     default:
         rc = fputc(ch, stream->file);
         break;
@@ -281,6 +323,9 @@ int xfileWriteString(const char* string, XFile* stream)
     case XFILE_TYPE_GZFILE:
         rc = gzputs(stream->gzfile, string);
         break;
+    case XFILE_TYPE_MEMORY:
+        rc = -1;
+        break;
     default:
         rc = fputs(string, stream->file);
         break;
@@ -309,6 +354,9 @@ size_t xfileRead(void* ptr, size_t size, size_t count, XFile* stream)
         // return wrong result.
         elementsRead = gzread(stream->gzfile, ptr, size * count);
         break;
+    case XFILE_TYPE_MEMORY:
+        elementsRead = xmemoryRead(ptr, size, count, &(stream->memory));
+        break;
     default:
         elementsRead = fread(ptr, size, count, stream->file);
         break;
@@ -337,6 +385,9 @@ size_t xfileWrite(const void* ptr, size_t size, size_t count, XFile* stream)
         // parameters this function can return wrong result.
         elementsWritten = gzwrite(stream->gzfile, ptr, size * count);
         break;
+    case XFILE_TYPE_MEMORY:
+        elementsWritten = 0;
+        break;
     default:
         elementsWritten = fwrite(ptr, size, count, stream->file);
         break;
@@ -359,6 +410,9 @@ int xfileSeek(XFile* stream, long offset, int origin)
     case XFILE_TYPE_GZFILE:
         result = gzseek(stream->gzfile, offset, origin);
         break;
+    case XFILE_TYPE_MEMORY:
+        result = xmemorySeek(&(stream->memory), offset, origin);
+        break;
     default:
         result = fseek(stream->file, offset, origin);
         break;
@@ -381,6 +435,9 @@ long xfileTell(XFile* stream)
     case XFILE_TYPE_GZFILE:
         pos = gztell(stream->gzfile);
         break;
+    case XFILE_TYPE_MEMORY:
+        pos = stream->memory.position;
+        break;
     default:
         pos = ftell(stream->file);
         break;
@@ -401,6 +458,9 @@ void xfileRewind(XFile* stream)
     case XFILE_TYPE_GZFILE:
         gzrewind(stream->gzfile);
         break;
+    case XFILE_TYPE_MEMORY:
+        stream->memory.position = 0;
+        break;
     default:
         rewind(stream->file);
         break;
@@ -421,6 +481,9 @@ int xfileEof(XFile* stream)
     case XFILE_TYPE_GZFILE:
         rc = gzeof(stream->gzfile);
         break;
+    case XFILE_TYPE_MEMORY:
+        rc = stream->memory.position >= stream->memory.size;
+        break;
     default:
         rc = feof(stream->file);
         break;
@@ -443,6 +506,9 @@ long xfileGetSize(XFile* stream)
     case XFILE_TYPE_GZFILE:
         fileSize = 0;
         break;
+    case XFILE_TYPE_MEMORY:
+        fileSize = stream->memory.size;
+        break;
     default:
         fileSize = getFileSize(stream->file);
         break;
@@ -823,4 +889,75 @@ static bool xlistEnumerateHandler(XListEnumerationContext* context)
     return true;
 }
 
+// [fread].
+static size_t xmemoryRead(void* ptr, size_t size, size_t count, XMemoryFile* stream)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t available = static_cast<size_t>(stream->size - stream->position) / size;
+    if (count > available) {
+        count = available;
+    }
+
+    memcpy(ptr, stream->data + stream->position, size * count);
+    stream->position += static_cast<long>(size * count);
+
+    return count;
+}
+
+// [compat_fgets].
+static char* xmemoryReadString(char* string, int size, XMemoryFile* stream)
+{
+    if (stream->position >= stream->size) {
+        return nullptr;
+    }
+
+    int length = 0;
+    while (length < size - 1 && stream->position < stream->size) {
+        char ch = static_cast<char>(stream->data[stream->position++]);
+        string[length++] = ch;
+        if (ch == '\n') {
+            break;
+        }
+    }
+
+    string[length] = '\0';
+
+    if (length >= 2 && string[length - 1] == '\n' && string[length - 2] == '\r') {
+        string[length - 2] = '\n';
+        string[length - 1] = '\0';
+    }
+
+    return string;
+}
+
+// [fseek].
+static int xmemorySeek(XMemoryFile* stream, long offset, int origin)
+{
+    long position;
+    switch (origin) {
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = stream->position + offset;
+        break;
+    case SEEK_END:
+        position = stream->size + offset;
+        break;
+    default:
+        return -1;
+    }
+
+    if (position < 0 || position > stream->size) {
+        return -1;
+    }
+
+    stream->position = position;
+
+    return 0;
+}
+
 } // namespace fallout
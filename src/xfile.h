@@ -14,6 +14,9 @@ typedef enum XFileType {
     XFILE_TYPE_FILE,
     XFILE_TYPE_DFILE,
     XFILE_TYPE_GZFILE,
+
+    // CE: Read-only stream over a memory block owned by the stream.
+    XFILE_TYPE_MEMORY,
 } XFileType;
 
 // A universal database of files.
@@ -34,12 +37,19 @@ typedef struct XBase {
     struct XBase* next;
 } XBase;
 
+typedef struct XMemoryFile {
+    unsigned char* data;
+    long size;
+    long position;
+} XMemoryFile;
+
 typedef struct XFile {
     XFileType type;
     union {
         FILE* file;
         DFile* dfile;
         gzFile gzfile;
+        XMemoryFile memory;
     };
 } XFile;
 
@@ -50,6 +60,7 @@ typedef struct XList {
 
 int xfileClose(XFile* stream);
 XFile* xfileOpen(const char* filename, const char* mode);
+XFile* xfileOpenMemory(void* data, long size);
 int xfilePrintFormatted(XFile* xfile, const char* format, ...);
 int xfilePrintFormattedArgs(XFile* stream, const char* format, va_list args);
 int xfileReadChar(XFile* stream);